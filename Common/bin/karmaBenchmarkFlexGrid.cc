@@ -0,0 +1,218 @@
+/**
+ * Standalone micro-benchmark for the bin lookup in `FlexGrid`
+ * (see `Karma/Common/interface/Providers/FlexGridBinProvider.h`).
+ *
+ * Reads a FlexGrid from a YAML file, generates random value tuples covering
+ * the binning range (and slightly beyond) and compares the time per lookup
+ * of the recursive tree walk and the flat lookup tables (single and batch
+ * lookups, on unsorted and sorted inputs). The results of all
+ * implementations are cross-checked against each other.
+ *
+ * Usage example:
+ *     karmaBenchmarkFlexGrid --flexGridFile $CMSSW_BASE/src/Karma/DijetAnalysis/data/binning/flexgrid_ys_yb_ptave_AK4PFCHS.yml
+ */
+
+// system include files
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "Karma/Common/interface/Providers/FlexGridBinProvider.h"
+#include "Karma/Common/interface/Tools/Benchmark.h"
+
+
+namespace {
+
+    /**
+     * Generate a random value tuple by descending the node tree: at each level,
+     * draw a value uniformly from the bin range of the node (enlarged by
+     * `overflowFraction` on both sides) and continue with the subnode of the bin
+     * containing the value. Tuples leaving the range are padded to `nLevels` values.
+     */
+    std::vector<double> randomValues(const FlexNode& rootNode, size_t nLevels, double overflowFraction, std::mt19937& rng) {
+        std::vector<double> values;
+        const FlexNode* node = &rootNode;
+        while (node) {
+            const auto& bins = node->getBins();
+            const double margin = overflowFraction * (bins.back() - bins.front());
+            std::uniform_real_distribution<double> valueDist(bins.front() - margin, bins.back() + margin);
+            const double value = valueDist(rng);
+            values.push_back(value);
+
+            const auto nextIter = std::upper_bound(bins.begin(), bins.end(), value);
+            if (node->hasSubstructure() && (nextIter != bins.begin()) && (nextIter != bins.end())) {
+                node = &node->getSubnode(std::distance(bins.begin(), nextIter) - 1);
+            }
+            else {
+                node = nullptr;
+            }
+        }
+        values.resize(std::max(values.size(), nLevels), 0.0);
+        return values;
+    }
+
+    /** Number of binning levels (along the first branch of the tree) */
+    size_t numLevels(const FlexNode& rootNode) {
+        size_t nLevels = 1;
+        for (const FlexNode* node = &rootNode; node->hasSubstructure(); node = &node->getSubnode(0)) {
+            ++nLevels;
+        }
+        return nLevels;
+    }
+
+}  // end namespace
+
+
+int main(int argc, char** argv) {
+
+    namespace po = boost::program_options;
+
+    // -- parse command line options
+
+    std::string flexGridFile;
+    size_t nLookups;
+    unsigned int seed;
+    double overflowFraction;
+    double minDuration;
+
+    po::options_description desc("Benchmark the FlexGrid bin lookup on random values. Options");
+    desc.add_options()
+        ("help,h", "print this message")
+        ("flexGridFile", po::value<std::string>(&flexGridFile)->required(), "YAML file containing the FlexGrid binning")
+        ("nLookups", po::value<size_t>(&nLookups)->default_value(10000), "number of random value tuples")
+        ("seed", po::value<unsigned int>(&seed)->default_value(42), "seed for the random number generator")
+        ("overflowFraction", po::value<double>(&overflowFraction)->default_value(0.05), "fraction of the bin range by which values may lie outside it")
+        ("minDuration", po::value<double>(&minDuration)->default_value(0.5), "minimum duration of each measurement (seconds)")
+    ;
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help")) {
+            std::cout << desc << std::endl;
+            return 0;
+        }
+        po::notify(vm);
+    }
+    catch (const po::error& err) {
+        std::cerr << "Error: " << err.what() << std::endl << desc << std::endl;
+        return 2;
+    }
+
+    // -- read FlexGrid and generate random values
+
+    const FlexGrid flexGrid(flexGridFile);
+    const size_t nLevels = numLevels(flexGrid._rootFlexNode);
+
+    std::mt19937 rng(seed);
+    std::vector<std::vector<double>> valueTuples(nLookups);
+    for (auto& values : valueTuples) {
+        values = randomValues(flexGrid._rootFlexNode, nLevels, overflowFraction, rng);
+    }
+
+    std::cout << "Benchmarking FlexGrid lookup on " << nLookups << " random value tuples (seed " << seed << ") with "
+              << nLevels << " binning levels from file: " << flexGridFile << std::endl << std::endl;
+
+    // columnar copies of the values for batch lookups (unsorted and sorted)
+    auto makeColumns = [&](const std::vector<std::vector<double>>& tuples) {
+        std::vector<std::vector<double>> columns(nLevels, std::vector<double>(tuples.size()));
+        for (size_t iTuple = 0; iTuple < tuples.size(); ++iTuple) {
+            for (size_t iLevel = 0; iLevel < nLevels; ++iLevel) {
+                columns[iLevel][iTuple] = tuples[iTuple][iLevel];
+            }
+        }
+        return columns;
+    };
+    auto sortedValueTuples = valueTuples;
+    // sort by bin (i.e. by the values of each level within the bins of the previous ones)
+    std::sort(sortedValueTuples.begin(), sortedValueTuples.end(), [&](const std::vector<double>& lhs, const std::vector<double>& rhs) {
+        return std::make_pair(flexGrid.findIndex(lhs), lhs.back()) < std::make_pair(flexGrid.findIndex(rhs), rhs.back());
+    });
+    const auto columns = makeColumns(valueTuples);
+    const auto sortedColumns = makeColumns(sortedValueTuples);
+    std::vector<const double*> columnPointers, sortedColumnPointers;
+    for (size_t iLevel = 0; iLevel < nLevels; ++iLevel) {
+        columnPointers.push_back(columns[iLevel].data());
+        sortedColumnPointers.push_back(sortedColumns[iLevel].data());
+    }
+    std::vector<int> batchIndices(nLookups);
+
+    // -- cross-check
+
+    int nMismatches = 0;
+    for (const auto& values : valueTuples) {
+        if (flexGrid.findIndex(values.data(), values.size()) != flexGrid.findIndexInTree(values)) {
+            ++nMismatches;
+        }
+    }
+    karma::FlexGridTables::SearchHint searchHint;
+    for (const auto* tuples : {&valueTuples, &sortedValueTuples}) {
+        for (auto* hint : {static_cast<karma::FlexGridTables::SearchHint*>(nullptr), &searchHint}) {
+            flexGrid.findIndices((tuples == &valueTuples) ? columnPointers.data() : sortedColumnPointers.data(), nLevels, nLookups, batchIndices.data(), hint);
+            for (size_t iTuple = 0; iTuple < nLookups; ++iTuple) {
+                if (batchIndices[iTuple] != flexGrid.findIndexInTree((*tuples)[iTuple])) {
+                    ++nMismatches;
+                }
+            }
+        }
+    }
+
+    // -- timing
+
+    int checksum = 0;  // prevent the lookups from being optimized away
+    double nsPerPass;
+
+    nsPerPass = karma::benchmark::timePerCall([&]() {
+        for (const auto& values : valueTuples) {
+            checksum += flexGrid.findIndexInTree(values);
+        }
+    }, minDuration);
+    karma::benchmark::printResult("tree walk", nsPerPass, nLookups, "lookup");
+
+    nsPerPass = karma::benchmark::timePerCall([&]() {
+        for (const auto& values : valueTuples) {
+            // as done by callers passing a braced list, which creates a temporary vector
+            checksum += flexGrid.findIndexInTree(std::vector<double>(values.begin(), values.end()));
+        }
+    }, minDuration);
+    karma::benchmark::printResult("tree walk (temporary vector)", nsPerPass, nLookups, "lookup");
+
+    nsPerPass = karma::benchmark::timePerCall([&]() {
+        for (const auto& values : valueTuples) {
+            checksum += flexGrid.findIndex(values.data(), values.size());
+        }
+    }, minDuration);
+    karma::benchmark::printResult("flat tables", nsPerPass, nLookups, "lookup");
+
+    nsPerPass = karma::benchmark::timePerCall([&]() {
+        flexGrid.findIndices(columnPointers.data(), nLevels, nLookups, batchIndices.data());
+        checksum += batchIndices.back();
+    }, minDuration);
+    karma::benchmark::printResult("flat tables (batch)", nsPerPass, nLookups, "lookup");
+
+    nsPerPass = karma::benchmark::timePerCall([&]() {
+        for (const auto& values : sortedValueTuples) {
+            checksum += flexGrid.findIndex(values.data(), values.size());
+        }
+    }, minDuration);
+    karma::benchmark::printResult("flat tables (sorted input)", nsPerPass, nLookups, "lookup");
+
+    nsPerPass = karma::benchmark::timePerCall([&]() {
+        flexGrid.findIndices(sortedColumnPointers.data(), nLevels, nLookups, batchIndices.data(), &searchHint);
+        checksum += batchIndices.back();
+    }, minDuration);
+    karma::benchmark::printResult("flat tables (batch + hints, sorted input)", nsPerPass, nLookups, "lookup");
+
+    std::cout << std::endl << "(checksum: " << checksum << ")" << std::endl;
+
+    if (nMismatches) {
+        std::cout << std::endl << "[ERROR] Cross-check failed: " << nMismatches << " mismatching lookup(s)!" << std::endl;
+        return 1;
+    }
+    std::cout << std::endl << "Cross-check passed: flat tables (single and batch) and tree walk give identical results." << std::endl;
+    return 0;
+}
@@ -0,0 +1,497 @@
+/**
+ * Standalone benchmark comparing the storage formats for jets: the regular
+ * (double-precision) format, the compact (single-precision) format used for
+ * reduced-size skims (see `Karma/SkimmingFormats/interface/CompactEvent.h`)
+ * and the structure-of-arrays format used for partial-column reads (see
+ * `Karma/SkimmingFormats/interface/JetSoA.h`).
+ *
+ * A synthetic skim is written to a ROOT file with one `TTree` branch per
+ * format, using the dictionaries generated from `classes_def.xml` (so that
+ * e.g. the `Float16_t` I/O type of the compact jet fields is applied by ROOT).
+ * The collections are written in split mode, and the regular format is
+ * written a second time unsplit. The benchmark reports the size per jet on
+ * disk and the read throughput (for the compact format, including the
+ * conversion back to `karma::Jet`). For the structure-of-arrays format, the
+ * read time of each column branch is reported, and a kinematic pre-selection
+ * reading only the `pt`, `eta` and `phi` branches is compared to reading
+ * whole jets. The jets read back are cross-checked against the input within
+ * the precision of each format.
+ *
+ * Usage example:
+ *     karmaBenchmarkJetFormats --nEvents 2000 --nJets 15
+ */
+
+// system include files
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "Compression.h"
+#include "TBranch.h"
+#include "TClass.h"
+#include "TFile.h"
+#include "TTree.h"
+
+#include "Karma/Common/interface/Tools/Benchmark.h"
+
+#include "Karma/SkimmingFormats/interface/Event.h"
+#include "Karma/SkimmingFormats/interface/CompactEvent.h"
+#include "Karma/SkimmingFormats/interface/JetSoA.h"
+
+
+namespace {
+
+    // -- data members of the jet formats
+
+    /** Precision with which a data member is stored in `karma::CompactJet` */
+    enum class Precision { Exact, Float, Float16 };
+
+    /** Description of one data member (names as in `karma::JetSoACollection`) */
+    struct FieldSpec {
+        const char* name;
+        Precision compactPrecision;
+    };
+
+    /** Number of data members of a jet (order as in `getFields()`) */
+    constexpr size_t N_FIELDS = 25;
+
+    // compact precision must be kept in sync with the `karma::CompactJet` entry in `classes_def.xml`
+    const FieldSpec jetFields[N_FIELDS] = {
+        {"pt", Precision::Float}, {"eta", Precision::Float}, {"phi", Precision::Float}, {"mass", Precision::Float},
+        {"uncorPt", Precision::Float}, {"uncorEta", Precision::Float}, {"uncorPhi", Precision::Float}, {"uncorMass", Precision::Float},
+        {"area", Precision::Float16},
+        {"nConstituents", Precision::Exact}, {"nCharged", Precision::Exact}, {"nElectrons", Precision::Exact}, {"nMuons", Precision::Exact}, {"nPhotons", Precision::Exact},
+        {"hadronFlavor", Precision::Exact}, {"partonFlavor", Precision::Exact},
+        {"neutralHadronFraction", Precision::Float16}, {"chargedHadronFraction", Precision::Float16}, {"chargedEMFraction", Precision::Float16},
+        {"neutralEMFraction", Precision::Float16}, {"muonFraction", Precision::Float16}, {"electronFraction", Precision::Float16},
+        {"photonFraction", Precision::Float16}, {"hfHadronFraction", Precision::Float16}, {"hfEMFraction", Precision::Float16},
+    };
+
+    constexpr int FLOAT16_MANTISSA_BITS = 12;  // ROOT default for `Float16_t` without range specification
+
+    /** Maximum expected relative deviation from the input for precision `precision` */
+    double tolerance(Precision precision) {
+        switch (precision) {
+            case Precision::Exact:
+                return 0.0;
+            case Precision::Float:
+                return 1e-6;  // includes rounding in the conversion between coordinate systems
+            case Precision::Float16:
+                return std::ldexp(1.0, -FLOAT16_MANTISSA_BITS);
+        }
+        return 0.0;
+    }
+
+    void getFields(const karma::Jet& jet, double* values) {
+        size_t i = 0;
+        for (double value : {jet.p4.pt(), jet.p4.eta(), jet.p4.phi(), jet.p4.mass()}) values[i++] = value;
+        for (double value : {jet.uncorP4.pt(), jet.uncorP4.eta(), jet.uncorP4.phi(), jet.uncorP4.mass()}) values[i++] = value;
+        values[i++] = jet.area;
+        for (int value : {jet.nConstituents, jet.nCharged, jet.nElectrons, jet.nMuons, jet.nPhotons, jet.hadronFlavor, jet.partonFlavor}) values[i++] = value;
+        for (double value : {jet.neutralHadronFraction, jet.chargedHadronFraction, jet.chargedEMFraction,
+                             jet.neutralEMFraction, jet.muonFraction, jet.electronFraction,
+                             jet.photonFraction, jet.hfHadronFraction, jet.hfEMFraction}) values[i++] = value;
+    }
+
+    // -- ROOT I/O
+
+    // branch names (trailing dot: sub-branches of split collections are prefixed with the branch name)
+    const char* const REGULAR_BRANCH = "regularJets.";
+    const char* const UNSPLIT_BRANCH = "unsplitJets";
+    const char* const COMPACT_BRANCH = "compactJets.";
+    const char* const SOA_BRANCH = "soaJets.";
+
+    /** Throw if there is no dictionary for a class written by the benchmark */
+    void checkDictionaries() {
+        for (const char* className : {"karma::JetCollection", "karma::CompactJetCollection", "karma::JetSoACollection"}) {
+            TClass* rootClass = TClass::GetClass(className);
+            if (!rootClass || !rootClass->HasDictionary()) {
+                throw std::runtime_error(std::string("No ROOT dictionary found for class '") + className + "': check that the Karma/SkimmingFormats library is available!");
+            }
+        }
+    }
+
+    /** Write the skim to tree 'Events' in file `fileName`, with one branch per jet format */
+    void writeSkim(const std::string& fileName, int compressionLevel, const std::vector<karma::JetCollection>& events) {
+        TFile file(fileName.c_str(), "RECREATE");
+        if (file.IsZombie()) {
+            throw std::runtime_error("Cannot create output file '" + fileName + "'!");
+        }
+        file.SetCompressionAlgorithm(ROOT::kZLIB);
+        file.SetCompressionLevel(compressionLevel);
+
+        karma::JetCollection jets;
+        karma::CompactJetCollection compactJets;
+        karma::JetSoACollection soaJets;
+        karma::JetCollection* jetsPtr = &jets;
+        karma::CompactJetCollection* compactJetsPtr = &compactJets;
+        karma::JetSoACollection* soaJetsPtr = &soaJets;
+
+        TTree* tree = new TTree("Events", "Events");  // owned by `file`
+        tree->Branch(REGULAR_BRANCH, &jetsPtr, 32000, 99);
+        tree->Branch(UNSPLIT_BRANCH, &jetsPtr, 32000, 0);
+        tree->Branch(COMPACT_BRANCH, &compactJetsPtr, 32000, 99);
+        tree->Branch(SOA_BRANCH, &soaJetsPtr, 32000, 99);
+
+        for (const auto& event : events) {
+            jets = event;
+            compactJets.resize(event.size());
+            soaJets.clear();
+            for (size_t iJet = 0; iJet < event.size(); ++iJet) {
+                karma::toCompact(event[iJet], compactJets[iJet]);
+                soaJets.push_back(event[iJet]);
+            }
+            tree->Fill();
+        }
+
+        file.Write();
+        file.Close();
+    }
+
+    /**
+     * Read all entries of `tree` with only the branches `branchNames` (and
+     * their sub-branches, for names ending in '*') enabled, calling
+     * `onEntry(iEntry)` after reading each entry
+     */
+    void readEntries(TTree& tree, const std::vector<std::string>& branchNames, const std::function<void(size_t)>& onEntry) {
+        tree.SetBranchStatus("*", 0);
+        for (const auto& branchName : branchNames) {
+            tree.SetBranchStatus(branchName.c_str(), 1);
+        }
+        const Long64_t nEntries = tree.GetEntries();
+        for (Long64_t iEntry = 0; iEntry < nEntries; ++iEntry) {
+            tree.GetEntry(iEntry);
+            onEntry(iEntry);
+        }
+    }
+
+    // -- synthetic skim
+
+    std::vector<karma::JetCollection> generateEvents(size_t nEvents, double meanNJets, unsigned int seed) {
+        std::mt19937 rng(seed);
+        std::poisson_distribution<int> nJetsDist(meanNJets);
+        std::exponential_distribution<double> ptDist(1.0 / 40.0);
+        std::uniform_real_distribution<double> etaDist(-4.7, 4.7);
+        std::uniform_real_distribution<double> phiDist(-M_PI, M_PI);
+        std::uniform_real_distribution<double> unitDist(0.0, 1.0);
+        std::normal_distribution<double> jecDist(1.1, 0.05);
+        std::normal_distribution<double> areaDist(0.5, 0.05);
+        std::poisson_distribution<int> countDist(8);
+        std::discrete_distribution<int> flavorDist({60, 10, 10, 5, 5, 10});
+        const int flavors[] = {0, 1, 2, 4, 5, 21};
+
+        std::vector<karma::JetCollection> events(nEvents);
+        for (auto& event : events) {
+            event.resize(nJetsDist(rng));
+            for (auto& jet : event) {
+                const double pt = 15.0 + ptDist(rng);
+                const double eta = etaDist(rng);
+                const double phi = phiDist(rng);
+                const double mass = 0.15 * pt * unitDist(rng);
+                const double jecFactor = jecDist(rng);
+                jet.p4 = karma::LorentzVector(pt, eta, phi, mass);
+                jet.uncorP4 = karma::LorentzVector(pt / jecFactor, eta, phi, mass / jecFactor);
+                jet.area = areaDist(rng);
+
+                jet.nCharged = countDist(rng);
+                jet.nElectrons = countDist(rng) / 8;
+                jet.nMuons = countDist(rng) / 8;
+                jet.nPhotons = countDist(rng);
+                jet.nConstituents = jet.nCharged + jet.nPhotons + countDist(rng) / 2;
+
+                jet.partonFlavor = flavors[flavorDist(rng)];
+                jet.hadronFlavor = ((jet.partonFlavor == 4) || (jet.partonFlavor == 5)) ? jet.partonFlavor : 0;
+
+                // energy fractions summing up to one
+                double fractions[5];
+                double sum = 0.0;
+                for (auto& fraction : fractions) {
+                    fraction = -std::log(unitDist(rng) + 1e-12);
+                    sum += fraction;
+                }
+                for (auto& fraction : fractions) {
+                    fraction /= sum;
+                }
+                const bool isHF = (std::abs(eta) > 3.0);
+                jet.neutralHadronFraction = isHF ? 0.0 : fractions[0];
+                jet.chargedHadronFraction = isHF ? 0.0 : fractions[1];
+                jet.photonFraction = isHF ? 0.0 : fractions[2];
+                jet.electronFraction = isHF ? 0.0 : 0.1 * fractions[3];
+                jet.muonFraction = isHF ? 0.0 : 0.1 * fractions[4];
+                jet.neutralEMFraction = jet.photonFraction;
+                jet.chargedEMFraction = jet.electronFraction;
+                jet.hfHadronFraction = isHF ? fractions[0] + fractions[1] : 0.0;
+                jet.hfEMFraction = isHF ? fractions[2] : 0.0;
+            }
+        }
+        return events;
+    }
+
+    // -- cross-check
+
+    /** Maximum relative deviation per data member between the jets of `events` and `referenceEvents` */
+    std::vector<double> maxRelativeDeviations(const std::vector<karma::JetCollection>& events, const std::vector<karma::JetCollection>& referenceEvents) {
+        std::vector<double> maxDeviations(N_FIELDS, 0.0);
+        if (events.size() != referenceEvents.size()) {
+            maxDeviations.assign(N_FIELDS, INFINITY);
+            return maxDeviations;
+        }
+        double values[N_FIELDS];
+        double referenceValues[N_FIELDS];
+        for (size_t iEvent = 0; iEvent < events.size(); ++iEvent) {
+            if (events[iEvent].size() != referenceEvents[iEvent].size()) {
+                maxDeviations.assign(N_FIELDS, INFINITY);
+                return maxDeviations;
+            }
+            for (size_t iJet = 0; iJet < events[iEvent].size(); ++iJet) {
+                getFields(events[iEvent][iJet], values);
+                getFields(referenceEvents[iEvent][iJet], referenceValues);
+                for (size_t iField = 0; iField < N_FIELDS; ++iField) {
+                    double deviation = std::abs(values[iField] - referenceValues[iField]);
+                    if (jetFields[iField].name == std::string("phi") || jetFields[iField].name == std::string("uncorPhi")) {
+                        deviation = std::min(deviation, 2 * M_PI - deviation);  // wrap-around at +/- pi
+                    }
+                    if (referenceValues[iField] != 0.0) {
+                        deviation /= std::abs(referenceValues[iField]);
+                    }
+                    maxDeviations[iField] = std::max(maxDeviations[iField], deviation);
+                }
+            }
+        }
+        return maxDeviations;
+    }
+
+}  // end namespace
+
+
+int main(int argc, char** argv) {
+
+    namespace po = boost::program_options;
+
+    // -- parse command line options
+
+    size_t nEvents;
+    double nJets;
+    int compressionLevel;
+    unsigned int seed;
+    double minDuration;
+    std::string fileName;
+
+    po::options_description desc("Benchmark the size and read throughput of the jet storage formats. Options");
+    desc.add_options()
+        ("help,h", "print this message")
+        ("nEvents", po::value<size_t>(&nEvents)->default_value(2000), "number of synthetic events")
+        ("nJets", po::value<double>(&nJets)->default_value(15), "mean number of jets per event")
+        ("compressionLevel", po::value<int>(&compressionLevel)->default_value(7), "ROOT file compression level (zlib)")
+        ("seed", po::value<unsigned int>(&seed)->default_value(42), "seed for the random number generator")
+        ("minDuration", po::value<double>(&minDuration)->default_value(0.5), "minimum duration of each measurement (seconds)")
+        ("fileName", po::value<std::string>(&fileName)->default_value("karmaBenchmarkJetFormats.root"), "ROOT file to write the synthetic skim to")
+        ("keepFile", "do not delete the ROOT file at the end")
+    ;
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (const po::error& err) {
+        std::cerr << "Error: " << err.what() << std::endl << desc << std::endl;
+        return 2;
+    }
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    // -- generate synthetic skim and write it to a ROOT file
+
+    try {
+        checkDictionaries();
+    }
+    catch (const std::exception& err) {
+        std::cerr << "Error: " << err.what() << std::endl;
+        return 2;
+    }
+
+    const std::vector<karma::JetCollection> events = generateEvents(nEvents, nJets, seed);
+    size_t nJetsTotal = 0;
+    for (const auto& event : events) {
+        nJetsTotal += event.size();
+    }
+
+    std::cout << "Benchmarking jet formats on " << nEvents << " synthetic events (seed " << seed << ") with "
+              << nJetsTotal << " jets in total" << std::endl;
+
+    writeSkim(fileName, compressionLevel, events);
+
+    std::unique_ptr<TFile> file(TFile::Open(fileName.c_str(), "READ"));
+    TTree* tree = file ? dynamic_cast<TTree*>(file->Get("Events")) : nullptr;
+    if (!tree) {
+        std::cerr << "Error: cannot read tree 'Events' from file '" << fileName << "'!" << std::endl;
+        return 2;
+    }
+
+    karma::JetCollection* jets = nullptr;
+    karma::JetCollection* unsplitJets = nullptr;
+    karma::CompactJetCollection* compactJets = nullptr;
+    karma::JetSoACollection* soaJets = nullptr;
+    tree->SetBranchAddress(REGULAR_BRANCH, &jets);
+    tree->SetBranchAddress(UNSPLIT_BRANCH, &unsplitJets);
+    tree->SetBranchAddress(COMPACT_BRANCH, &compactJets);
+    tree->SetBranchAddress(SOA_BRANCH, &soaJets);
+
+    // -- sizes
+
+    std::cout << std::endl << "Size on disk (zlib level " << compressionLevel << ")" << std::endl;
+    auto printSize = [&](const std::string& name, const char* branchName) {
+        const TBranch* branch = tree->GetBranch(branchName);
+        std::cout << "  " << std::left << std::setw(36) << name << std::right << ": "
+                  << static_cast<double>(branch->GetTotBytes("*")) / nJetsTotal << " bytes/jet uncompressed, "
+                  << static_cast<double>(branch->GetZipBytes("*")) / nJetsTotal << " bytes/jet compressed" << std::endl;
+    };
+    printSize("karma::JetCollection (split)", REGULAR_BRANCH);
+    printSize("karma::JetCollection (unsplit)", UNSPLIT_BRANCH);
+    printSize("karma::CompactJetCollection (split)", COMPACT_BRANCH);
+    printSize("karma::JetSoACollection (split)", SOA_BRANCH);
+    std::cout << "  compressed size ratio (compact/regular): "
+              << static_cast<double>(tree->GetBranch(COMPACT_BRANCH)->GetZipBytes("*")) / tree->GetBranch(REGULAR_BRANCH)->GetZipBytes("*") << std::endl;
+
+    const std::string regularBranches = std::string(REGULAR_BRANCH) + "*";
+    const std::string unsplitBranches = std::string(UNSPLIT_BRANCH) + "*";
+    const std::string compactBranches = std::string(COMPACT_BRANCH) + "*";
+    const std::string soaBranches = std::string(SOA_BRANCH) + "*";
+
+    // -- read throughput
+
+    std::cout << std::endl << "Reading jet collections" << std::endl;
+    std::vector<karma::JetCollection> expandedEvents(nEvents);
+    double nsPerPass;
+
+    nsPerPass = karma::benchmark::timePerCall([&]() {
+        readEntries(*tree, {regularBranches}, [](size_t) {});
+    }, minDuration);
+    karma::benchmark::printResult("karma::JetCollection", nsPerPass, nJetsTotal, "jet");
+
+    auto expand = [&](size_t iEvent) {
+        expandedEvents[iEvent].resize(compactJets->size());
+        for (size_t iJet = 0; iJet < compactJets->size(); ++iJet) {
+            karma::fromCompact((*compactJets)[iJet], expandedEvents[iEvent][iJet]);
+        }
+    };
+    nsPerPass = karma::benchmark::timePerCall([&]() {
+        readEntries(*tree, {compactBranches}, expand);
+    }, minDuration);
+    karma::benchmark::printResult("karma::CompactJetCollection (incl. conversion)", nsPerPass, nJetsTotal, "jet");
+
+    // -- partial-column reads (structure of arrays)
+
+    std::cout << std::endl << "Per-branch read times (karma::JetSoACollection)" << std::endl;
+    for (size_t iField = 0; iField < N_FIELDS; ++iField) {
+        const std::string columnBranch = std::string(SOA_BRANCH) + jetFields[iField].name;
+        nsPerPass = karma::benchmark::timePerCall([&]() {
+            readEntries(*tree, {columnBranch}, [](size_t) {});
+        }, minDuration);
+        karma::benchmark::printResult("branch '" + columnBranch + "'", nsPerPass, nJetsTotal, "jet");
+    }
+
+    // kinematic pre-selection, including a veto of a detector region in (eta, phi)
+    auto isSelected = [](double pt, double eta, double phi) {
+        return (pt > 30.0) && (std::abs(eta) < 2.5) && !((eta < -1.3) && (phi > -1.57) && (phi < -0.87));
+    };
+    size_t nSelectedUnsplit = 0;
+    size_t nSelectedSoA = 0;
+    size_t nSelectedSoAAllColumns = 0;
+
+    std::cout << std::endl << "Pre-selection on pt/eta/phi (read + select)" << std::endl;
+    nsPerPass = karma::benchmark::timePerCall([&]() {
+        nSelectedUnsplit = 0;
+        readEntries(*tree, {unsplitBranches}, [&](size_t) {
+            for (const auto& jet : *unsplitJets) {
+                nSelectedUnsplit += isSelected(jet.p4.pt(), jet.p4.eta(), jet.p4.phi());
+            }
+        });
+    }, minDuration);
+    karma::benchmark::printResult("karma::JetCollection (unsplit)", nsPerPass, nJetsTotal, "jet");
+
+    nsPerPass = karma::benchmark::timePerCall([&]() {
+        nSelectedSoAAllColumns = 0;
+        readEntries(*tree, {soaBranches}, [&](size_t) {
+            for (const auto& jet : *soaJets) {
+                nSelectedSoAAllColumns += isSelected(jet.pt(), jet.eta(), jet.phi());
+            }
+        });
+    }, minDuration);
+    karma::benchmark::printResult("karma::JetSoACollection (all branches)", nsPerPass, nJetsTotal, "jet");
+
+    const std::vector<std::string> kinematicBranches = {std::string(SOA_BRANCH) + "pt", std::string(SOA_BRANCH) + "eta", std::string(SOA_BRANCH) + "phi"};
+    nsPerPass = karma::benchmark::timePerCall([&]() {
+        nSelectedSoA = 0;
+        readEntries(*tree, kinematicBranches, [&](size_t) {
+            for (size_t iJet = 0; iJet < soaJets->pt.size(); ++iJet) {
+                nSelectedSoA += isSelected(soaJets->pt[iJet], soaJets->eta[iJet], soaJets->phi[iJet]);
+            }
+        });
+    }, minDuration);
+    karma::benchmark::printResult("karma::JetSoACollection (pt/eta/phi only)", nsPerPass, nJetsTotal, "jet");
+
+    // -- cross-check
+
+    std::vector<karma::JetCollection> readEvents(nEvents);
+    std::vector<karma::JetCollection> readUnsplitEvents(nEvents);
+    std::vector<karma::JetCollection> readSoAEvents(nEvents);
+    readEntries(*tree, {regularBranches, unsplitBranches, compactBranches, soaBranches}, [&](size_t iEvent) {
+        readEvents[iEvent] = *jets;
+        readUnsplitEvents[iEvent] = *unsplitJets;
+        readSoAEvents[iEvent] = soaJets->toJetCollection();
+        expand(iEvent);
+    });
+
+    file.reset();
+    if (!vm.count("keepFile")) {
+        std::remove(fileName.c_str());
+    }
+
+    std::cout << std::endl << "Maximum relative deviation from input (regular / compact)" << std::endl;
+    const std::vector<double> deviations = maxRelativeDeviations(readEvents, events);
+    const std::vector<double> compactDeviations = maxRelativeDeviations(expandedEvents, events);
+    bool passed = true;
+    for (size_t iField = 0; iField < N_FIELDS; ++iField) {
+        const bool fieldPassed = (deviations[iField] == 0.0) &&
+                                 (compactDeviations[iField] <= tolerance(jetFields[iField].compactPrecision));
+        passed &= fieldPassed;
+        std::cout << "  " << std::left << std::setw(24) << jetFields[iField].name << std::right << std::scientific << std::setprecision(2)
+                  << std::setw(10) << deviations[iField] << " / " << std::setw(10) << compactDeviations[iField]
+                  << (fieldPassed ? "" : "  <-- above tolerance") << std::defaultfloat << std::endl;
+    }
+
+    if (!passed) {
+        std::cout << std::endl << "[ERROR] Cross-check failed: jets read back deviate from input beyond the precision of the format!" << std::endl;
+        return 1;
+    }
+
+    // unsplit and structure-of-arrays collections must reproduce the input exactly
+    for (const auto& readBackEvents : {&readUnsplitEvents, &readSoAEvents}) {
+        for (double deviation : maxRelativeDeviations(*readBackEvents, events)) {
+            passed &= (deviation == 0.0);
+        }
+    }
+    passed &= (nSelectedSoA == nSelectedUnsplit) && (nSelectedSoAAllColumns == nSelectedUnsplit);
+    if (!passed) {
+        std::cout << std::endl << "[ERROR] Cross-check failed: unsplit or structure-of-arrays collections differ from input ("
+                  << nSelectedUnsplit << ", " << nSelectedSoAAllColumns << ", " << nSelectedSoA << " jets selected)!" << std::endl;
+        return 1;
+    }
+    std::cout << std::endl << "Cross-check passed: all values agree within the precision of the format"
+              << " (" << nSelectedUnsplit << " jets selected in all formats)." << std::endl;
+    return 0;
+}
@@ -0,0 +1,592 @@
+/**
+ * Standalone micro-benchmark for the matchers in `Karma/Common/interface/Tools/Matchers.h`.
+ *
+ * Generates synthetic events with karma::Jet and karma::TriggerObject collections
+ * and reports the time spent matching them, per call and per evaluated pair.
+ *
+ * A copy of the original matching algorithms (full metric matrix, rescanned once
+ * per accepted match) is kept in this file as the reference implementation. The
+ * results of every matcher variant, including the `GenericMatcher` wrappers, are
+ * compared against it on the benchmark events and on randomized inputs with
+ * varying collection sizes, `maxMatches`, `allowIdenticalIndices` and exact ties.
+ *
+ * Usage example:
+ *     karmaBenchmarkMatchers --nJets 20 --nTriggerObjects 300 --seed 42
+ */
+
+// system include files
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "Karma/Common/interface/Tools/Benchmark.h"
+#include "Karma/Common/interface/Tools/Matchers.h"
+
+#include "Karma/SkimmingFormats/interface/Event.h"
+
+
+namespace {
+
+    typedef std::vector<std::pair<int, int>> MatchResult;
+
+    /** Synthetic event content */
+    struct SyntheticEvent {
+        karma::JetCollection jets;
+        karma::TriggerObjectCollection triggerObjects;
+    };
+
+    /** Fill the kinematics of `collection` with `n` random objects */
+    template<typename TCollection>
+    void fillRandomKinematics(TCollection& collection, size_t n, double maxAbsEta, std::mt19937& rng) {
+        std::uniform_real_distribution<double> etaDist(-maxAbsEta, maxAbsEta);
+        std::uniform_real_distribution<double> phiDist(-M_PI, M_PI);
+        std::exponential_distribution<double> ptDist(1.0 / 50.0);
+
+        collection.resize(n);
+        for (auto& object : collection) {
+            object.p4 = karma::LorentzVector(20.0 + ptDist(rng), etaDist(rng), phiDist(rng), 5.0);
+        }
+    }
+
+    // -- reference implementations
+
+    /**
+     * Reference implementation of the injective lowest-metric matching, kept identical
+     * to the original `LowestMetricMatcher::match` (apart from storing the metric
+     * matrix on the heap): the full metric matrix is computed and rescanned for the
+     * lowest remaining value once per accepted match.
+     */
+    template<typename TPrimaryCollection, typename TSecondaryCollection, typename MetricFunctor>
+    void referenceLowestMetricMatch(const TPrimaryCollection& primaryCollection, const TSecondaryCollection& secondaryCollection,
+                                    const MetricFunctor& metricFunctor, double maxMetricValue, size_t maxMatches, bool allowIdenticalIndices,
+                                    MatchResult& matchResult) {
+
+        matchResult.clear();
+
+        // do matching only if collections are not empty
+        if ((primaryCollection.size() == 0) || (secondaryCollection.size() == 0))
+            return;
+
+        const size_t nPrimary = primaryCollection.size();
+        const size_t nSecondary = secondaryCollection.size();
+
+        // -- compute metric for all primary-secondary pairs
+        std::vector<double> metricMatrix(nPrimary * nSecondary);
+        for (size_t iPrimary = 0; iPrimary < nPrimary; ++iPrimary) {
+            const auto& primaryElement = primaryCollection.at(iPrimary);
+
+            for (size_t iSecondary = 0; iSecondary < nSecondary; ++iSecondary) {
+                double& metricValue = metricMatrix[iPrimary * nSecondary + iSecondary];
+
+                // make this pairing impossible if indices are the same and matching them is not allowed
+                if ((!allowIdenticalIndices) && (iPrimary == iSecondary)) {
+                    metricValue = std::numeric_limits<double>::quiet_NaN();
+                    continue;
+                }
+
+                metricValue = metricFunctor(secondaryCollection.at(iSecondary).p4, primaryElement.p4);
+                if (!(metricValue <= maxMetricValue)) {
+                    metricValue = std::numeric_limits<double>::quiet_NaN();
+                }
+            }
+        }
+
+        // -- do actual matching
+        for (size_t iIteration = 0; iIteration < nPrimary; ++iIteration) {
+
+            // identify pair of indices with best match (lowest overall metric value)
+            int bestMatchPrimaryIndex = -1;
+            int bestMatchSecondaryIndex = -1;
+            double bestMatchMetricValue = std::numeric_limits<double>::quiet_NaN();
+            for (size_t iSecondary = 0; iSecondary < nSecondary; ++iSecondary) {
+                for (size_t iPrimary = 0; iPrimary < nPrimary; ++iPrimary) {
+                    const double metricValue = metricMatrix[iPrimary * nSecondary + iSecondary];
+                    if (!std::isnan(metricValue)) {
+                        if ((metricValue < bestMatchMetricValue) || (std::isnan(bestMatchMetricValue))) {
+                            bestMatchPrimaryIndex = iPrimary;
+                            bestMatchSecondaryIndex = iSecondary;
+                            bestMatchMetricValue = metricValue;
+                        }
+                    }
+                }
+            }
+
+            // if no best match is found, all primary elements have been matched -> exit
+            if (std::isnan(bestMatchMetricValue))
+                break;
+
+            matchResult.emplace_back(bestMatchPrimaryIndex, bestMatchSecondaryIndex);
+
+            // return early if we reached the maximum number of allowed matched
+            if ((maxMatches > 0) && (matchResult.size() >= maxMatches))
+                return;
+
+            // disallow further matches invoving these indices
+            for (size_t iPrimary = 0; iPrimary < nPrimary; ++iPrimary) {
+                metricMatrix[iPrimary * nSecondary + bestMatchSecondaryIndex] = std::numeric_limits<double>::quiet_NaN();
+            }
+            for (size_t iSecondary = 0; iSecondary < nSecondary; ++iSecondary) {
+                metricMatrix[bestMatchPrimaryIndex * nSecondary + iSecondary] = std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+    }
+
+    /**
+     * Reference implementation of the threshold matching, kept identical to the
+     * original `MetricThresholdMatcher::match`.
+     */
+    template<typename TPrimaryCollection, typename TSecondaryCollection, typename MetricFunctor>
+    void referenceThresholdMatch(const TPrimaryCollection& primaryCollection, const TSecondaryCollection& secondaryCollection,
+                                 const MetricFunctor& metricFunctor, double maxMetricValue, size_t maxMatches, bool allowIdenticalIndices,
+                                 MatchResult& matchResult) {
+
+        matchResult.clear();
+
+        for (size_t iPrimary = 0; iPrimary < primaryCollection.size(); ++iPrimary) {
+            for (size_t iSecondary = 0; iSecondary < secondaryCollection.size(); ++iSecondary) {
+
+                // skip this pairing if indices are the same and matching them is not allowed
+                if ((!allowIdenticalIndices) && (iPrimary == iSecondary)) {
+                    continue;
+                }
+
+                const double metricValue = metricFunctor(primaryCollection.at(iPrimary).p4, secondaryCollection.at(iSecondary).p4);
+
+                // match *every* object within configured max metric value
+                if (metricValue <= maxMetricValue) {
+                    matchResult.emplace_back(iPrimary, iSecondary);
+                }
+
+                // return early if we reached the maximum number of allowed matched
+                if ((maxMatches > 0) && (matchResult.size() >= maxMatches)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    // -- benchmark helpers
+
+    /**
+     * Run `matchFunction(event, matchResult)` over all events. Returns the time per
+     * event, and writes the results of the first pass to `results` for cross-checks.
+     */
+    template<typename MatchFunction>
+    double runMatcher(MatchFunction matchFunction, const std::vector<SyntheticEvent>& events,
+                      double minDuration, std::vector<MatchResult>& results) {
+        MatchResult matchResult;
+        results.clear();
+        for (const auto& event : events) {
+            matchFunction(event, matchResult);
+            results.push_back(matchResult);
+        }
+
+        const double nsPerPass = karma::benchmark::timePerCall([&]() {
+            for (const auto& event : events) {
+                matchFunction(event, matchResult);
+            }
+        }, minDuration);
+        return nsPerPass / events.size();
+    }
+
+    /** Compare results to reference; print and count mismatching events */
+    int crossCheck(const std::string& name, const std::vector<MatchResult>& results, const std::vector<MatchResult>& reference) {
+        int nMismatches = 0;
+        for (size_t iEvent = 0; iEvent < reference.size(); ++iEvent) {
+            if (results[iEvent] != reference[iEvent]) {
+                ++nMismatches;
+            }
+        }
+        if (nMismatches) {
+            std::cout << "  [ERROR] " << name << ": results differ from reference in "
+                      << nMismatches << " of " << reference.size() << " events!" << std::endl;
+        }
+        return nMismatches;
+    }
+
+    /** Copy the kinematics of randomly chosen objects onto other objects, creating exact ties */
+    template<typename TCollection>
+    void addRandomDuplicates(TCollection& collection, size_t nDuplicates, std::mt19937& rng) {
+        if (collection.size() < 2)
+            return;
+        std::uniform_int_distribution<size_t> indexDist(0, collection.size() - 1);
+        for (size_t iDuplicate = 0; iDuplicate < nDuplicates; ++iDuplicate) {
+            collection[indexDist(rng)].p4 = collection[indexDist(rng)].p4;
+        }
+    }
+
+    /**
+     * Compare all matcher variants to the reference implementations on `nTrials`
+     * randomized inputs. Collection sizes (including empty collections), the
+     * `maxMatches` and `allowIdenticalIndices` settings and the number of objects
+     * with identical kinematics (exact metric ties) are drawn at random for each trial.
+     * Returns the number of mismatching results.
+     */
+    int randomizedCrossCheck(size_t nTrials, double maxDeltaR, double maxDeltaInvariantMass, std::mt19937& rng) {
+        typedef karma::JetCollection Jets;
+        typedef karma::TriggerObjectCollection TriggerObjects;
+
+        std::uniform_int_distribution<size_t> nJetsDist(0, 30);
+        std::uniform_int_distribution<size_t> nTriggerObjectsDist(0, 80);
+        std::uniform_int_distribution<size_t> nDuplicatesDist(0, 10);
+        std::uniform_int_distribution<size_t> maxMatchesDist(0, 6);
+        std::uniform_real_distribution<double> maxAbsEtaDist(0.5, 5.0);
+        std::bernoulli_distribution coinDist(0.5);
+
+        int nMismatches = 0;
+        size_t nTrialsPrinted = 0;
+        MatchResult reference;
+        MatchResult result;
+
+        auto compare = [&](const std::string& name, size_t iTrial, const MatchResult& matchResult) {
+            if (matchResult == reference)
+                return;
+            ++nMismatches;
+            if (nTrialsPrinted++ < 10) {
+                std::cout << "  [ERROR] " << name << ": result differs from reference in trial " << iTrial
+                          << " (" << matchResult.size() << " vs. " << reference.size() << " matches)" << std::endl;
+            }
+        };
+
+        for (size_t iTrial = 0; iTrial < nTrials; ++iTrial) {
+
+            // -- draw random inputs and settings
+            Jets jets;
+            TriggerObjects triggerObjects;
+            const double maxAbsEta = maxAbsEtaDist(rng);
+            fillRandomKinematics(jets, nJetsDist(rng), maxAbsEta, rng);
+            fillRandomKinematics(triggerObjects, nTriggerObjectsDist(rng), maxAbsEta, rng);
+            addRandomDuplicates(jets, nDuplicatesDist(rng), rng);
+            addRandomDuplicates(triggerObjects, nDuplicatesDist(rng), rng);
+
+            const size_t maxMatches = (maxMatchesDist(rng) + 1) / 2;  // zero (unlimited) in ~30% of trials
+            const bool allowIdenticalIndices = coinDist(rng);
+
+            // -- lowest DeltaR (injective)
+            referenceLowestMetricMatch(jets, triggerObjects, karma::DeltaRFunctor(), maxDeltaR, maxMatches, allowIdenticalIndices, reference);
+            {
+                karma::StaticLowestDeltaRMatcher<Jets, TriggerObjects> matcher(maxDeltaR, maxMatches, allowIdenticalIndices);
+                matcher.match(jets, triggerObjects, result);
+                compare("StaticLowestDeltaRMatcher", iTrial, result);
+            }
+            {
+                karma::StaticLowestDeltaRMatcher<Jets, TriggerObjects> matcher(maxDeltaR, maxMatches, allowIdenticalIndices, /* useEtaPhiGrid = */ true);
+                matcher.match(jets, triggerObjects, result);
+                compare("StaticLowestDeltaRMatcher (eta-phi grid)", iTrial, result);
+            }
+            {
+                karma::StaticCachedLowestDeltaRMatcher<Jets, TriggerObjects> matcher(maxDeltaR, maxMatches, allowIdenticalIndices);
+                matcher.match(jets, triggerObjects, result);
+                compare("StaticCachedLowestDeltaRMatcher", iTrial, result);
+            }
+            {
+                karma::LowestDeltaRMatcher<Jets, TriggerObjects> matcher(maxDeltaR, maxMatches, allowIdenticalIndices);
+                compare("LowestDeltaRMatcher", iTrial, matcher.match(jets, triggerObjects));
+            }
+            {
+                karma::LowestDeltaRMatcher<Jets, TriggerObjects> matcher(maxDeltaR, maxMatches, allowIdenticalIndices, /* useEtaPhiGrid = */ true);
+                compare("LowestDeltaRMatcher (eta-phi grid)", iTrial, matcher.match(jets, triggerObjects));
+            }
+            {
+                karma::CachedLowestDeltaRMatcher<Jets, TriggerObjects> matcher(maxDeltaR, maxMatches, allowIdenticalIndices);
+                compare("CachedLowestDeltaRMatcher", iTrial, matcher.match(jets, triggerObjects));
+            }
+
+            // -- DeltaR threshold (non-injective)
+            referenceThresholdMatch(jets, triggerObjects, karma::DeltaRFunctor(), maxDeltaR, maxMatches, allowIdenticalIndices, reference);
+            {
+                karma::StaticDeltaRThresholdMatcher<Jets, TriggerObjects> matcher(maxDeltaR, maxMatches, allowIdenticalIndices);
+                matcher.match(jets, triggerObjects, result);
+                compare("StaticDeltaRThresholdMatcher", iTrial, result);
+            }
+            {
+                karma::StaticDeltaRThresholdMatcher<Jets, TriggerObjects> matcher(maxDeltaR, maxMatches, allowIdenticalIndices, /* useEtaPhiGrid = */ true);
+                matcher.match(jets, triggerObjects, result);
+                compare("StaticDeltaRThresholdMatcher (eta-phi grid)", iTrial, result);
+            }
+            {
+                karma::StaticCachedDeltaRThresholdMatcher<Jets, TriggerObjects> matcher(maxDeltaR, maxMatches, allowIdenticalIndices);
+                matcher.match(jets, triggerObjects, result);
+                compare("StaticCachedDeltaRThresholdMatcher", iTrial, result);
+            }
+            {
+                karma::DeltaRThresholdMatcher<Jets, TriggerObjects> matcher(maxDeltaR, maxMatches, allowIdenticalIndices);
+                compare("DeltaRThresholdMatcher", iTrial, matcher.match(jets, triggerObjects));
+            }
+            {
+                karma::DeltaRThresholdMatcher<Jets, TriggerObjects> matcher(maxDeltaR, maxMatches, allowIdenticalIndices, /* useEtaPhiGrid = */ true);
+                compare("DeltaRThresholdMatcher (eta-phi grid)", iTrial, matcher.match(jets, triggerObjects));
+            }
+            {
+                karma::CachedDeltaRThresholdMatcher<Jets, TriggerObjects> matcher(maxDeltaR, maxMatches, allowIdenticalIndices);
+                compare("CachedDeltaRThresholdMatcher", iTrial, matcher.match(jets, triggerObjects));
+            }
+
+            // -- lowest absolute invariant mass difference (jets x jets)
+            const karma::AbsDeltaInvariantMassFunctor invariantMassFunctor(91.1876);
+            referenceLowestMetricMatch(jets, jets, invariantMassFunctor, maxDeltaInvariantMass, maxMatches, allowIdenticalIndices, reference);
+            {
+                karma::StaticLowestAbsDeltaInvariantMassMatcher<Jets> matcher(91.1876, maxDeltaInvariantMass, maxMatches, allowIdenticalIndices);
+                matcher.match(jets, jets, result);
+                compare("StaticLowestAbsDeltaInvariantMassMatcher", iTrial, result);
+            }
+            {
+                karma::LowestAbsDeltaInvariantMassMatcher<Jets> matcher(91.1876, maxDeltaInvariantMass, maxMatches, allowIdenticalIndices);
+                compare("LowestAbsDeltaInvariantMassMatcher", iTrial, matcher.match(jets, jets));
+            }
+        }
+
+        return nMismatches;
+    }
+
+}  // end namespace
+
+
+int main(int argc, char** argv) {
+
+    namespace po = boost::program_options;
+
+    // -- parse command line options
+
+    size_t nJets;
+    size_t nTriggerObjects;
+    size_t nEvents;
+    unsigned int seed;
+    double maxDeltaR;
+    double maxDeltaInvariantMass;
+    double minDuration;
+    size_t nRandomTrials;
+    size_t maxScalingSize;
+
+    po::options_description desc("Benchmark the matching algorithms on synthetic events. Options");
+    desc.add_options()
+        ("help,h", "print this message")
+        ("nJets", po::value<size_t>(&nJets)->default_value(20), "number of jets per event")
+        ("nTriggerObjects", po::value<size_t>(&nTriggerObjects)->default_value(300), "number of trigger objects per event")
+        ("nEvents", po::value<size_t>(&nEvents)->default_value(100), "number of synthetic events")
+        ("seed", po::value<unsigned int>(&seed)->default_value(42), "seed for the random number generator")
+        ("maxDeltaR", po::value<double>(&maxDeltaR)->default_value(0.4), "maximum DeltaR for DeltaR matchers")
+        ("maxDeltaInvariantMass", po::value<double>(&maxDeltaInvariantMass)->default_value(30.0), "maximum invariant mass difference for invariant mass matcher")
+        ("minDuration", po::value<double>(&minDuration)->default_value(0.5), "minimum duration of each measurement (seconds)")
+        ("nRandomTrials", po::value<size_t>(&nRandomTrials)->default_value(2000), "number of randomized inputs compared to the reference implementation")
+        ("maxScalingSize", po::value<size_t>(&maxScalingSize)->default_value(500), "largest collection size (n x n) in the scaling comparison (0 to disable)")
+    ;
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (const po::error& err) {
+        std::cerr << "Error: " << err.what() << std::endl << desc << std::endl;
+        return 2;
+    }
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    // -- generate synthetic events
+
+    std::mt19937 rng(seed);
+    std::vector<SyntheticEvent> events(nEvents);
+    for (auto& event : events) {
+        fillRandomKinematics(event.jets, nJets, 4.7, rng);
+        fillRandomKinematics(event.triggerObjects, nTriggerObjects, 5.0, rng);
+    }
+
+    std::cout << "Benchmarking matchers on " << nEvents << " synthetic events (seed " << seed << ") with "
+              << nJets << " jets and " << nTriggerObjects << " trigger objects each" << std::endl;
+
+    typedef karma::JetCollection Jets;
+    typedef karma::TriggerObjectCollection TriggerObjects;
+
+    int nMismatches = 0;
+    std::vector<MatchResult> reference;
+    std::vector<MatchResult> results;
+    double nsPerEvent;
+
+    // -- LowestDeltaRMatcher (jets vs. trigger objects)
+
+    const double pairsJetTriggerObject = nJets * nTriggerObjects;
+    std::cout << std::endl << "LowestDeltaRMatcher (jets x trigger objects, maxDeltaR = " << maxDeltaR << ")" << std::endl;
+    {
+        nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+            referenceLowestMetricMatch(event.jets, event.triggerObjects, karma::DeltaRFunctor(), maxDeltaR, 0, true, matchResult);
+        }, events, minDuration, reference);
+        karma::benchmark::printResult("reference (metric matrix rescan)", nsPerEvent, pairsJetTriggerObject, "pair");
+    }
+    {
+        karma::LowestDeltaRMatcher<Jets, TriggerObjects> matcher(maxDeltaR);
+        nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+            matchResult = matcher.match(event.jets, event.triggerObjects);
+        }, events, minDuration, results);
+        karma::benchmark::printResult("LowestDeltaRMatcher", nsPerEvent, pairsJetTriggerObject, "pair");
+        nMismatches += crossCheck("LowestDeltaRMatcher", results, reference);
+    }
+    {
+        karma::StaticLowestDeltaRMatcher<Jets, TriggerObjects> matcher(maxDeltaR);
+        nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+            matcher.match(event.jets, event.triggerObjects, matchResult);
+        }, events, minDuration, results);
+        karma::benchmark::printResult("StaticLowestDeltaRMatcher", nsPerEvent, pairsJetTriggerObject, "pair");
+        nMismatches += crossCheck("StaticLowestDeltaRMatcher", results, reference);
+    }
+    {
+        karma::StaticLowestDeltaRMatcher<Jets, TriggerObjects> matcher(maxDeltaR, 0, true, /* useEtaPhiGrid = */ true);
+        nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+            matcher.match(event.jets, event.triggerObjects, matchResult);
+        }, events, minDuration, results);
+        karma::benchmark::printResult("StaticLowestDeltaRMatcher (eta-phi grid)", nsPerEvent, pairsJetTriggerObject, "pair");
+        nMismatches += crossCheck("StaticLowestDeltaRMatcher (eta-phi grid)", results, reference);
+    }
+    {
+        karma::StaticCachedLowestDeltaRMatcher<Jets, TriggerObjects> matcher(maxDeltaR);
+        nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+            matcher.match(event.jets, event.triggerObjects, matchResult);
+        }, events, minDuration, results);
+        karma::benchmark::printResult("StaticCachedLowestDeltaRMatcher", nsPerEvent, pairsJetTriggerObject, "pair");
+        nMismatches += crossCheck("StaticCachedLowestDeltaRMatcher", results, reference);
+    }
+
+    // -- DeltaRThresholdMatcher (jets vs. trigger objects)
+
+    std::cout << std::endl << "DeltaRThresholdMatcher (jets x trigger objects, maxDeltaR = " << maxDeltaR << ")" << std::endl;
+    {
+        nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+            referenceThresholdMatch(event.jets, event.triggerObjects, karma::DeltaRFunctor(), maxDeltaR, 0, true, matchResult);
+        }, events, minDuration, reference);
+        karma::benchmark::printResult("reference (all pairs)", nsPerEvent, pairsJetTriggerObject, "pair");
+    }
+    {
+        karma::DeltaRThresholdMatcher<Jets, TriggerObjects> matcher(maxDeltaR);
+        nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+            matchResult = matcher.match(event.jets, event.triggerObjects);
+        }, events, minDuration, results);
+        karma::benchmark::printResult("DeltaRThresholdMatcher", nsPerEvent, pairsJetTriggerObject, "pair");
+        nMismatches += crossCheck("DeltaRThresholdMatcher", results, reference);
+    }
+    {
+        karma::StaticDeltaRThresholdMatcher<Jets, TriggerObjects> matcher(maxDeltaR);
+        nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+            matcher.match(event.jets, event.triggerObjects, matchResult);
+        }, events, minDuration, results);
+        karma::benchmark::printResult("StaticDeltaRThresholdMatcher", nsPerEvent, pairsJetTriggerObject, "pair");
+        nMismatches += crossCheck("StaticDeltaRThresholdMatcher", results, reference);
+    }
+    {
+        karma::StaticDeltaRThresholdMatcher<Jets, TriggerObjects> matcher(maxDeltaR, 0, true, /* useEtaPhiGrid = */ true);
+        nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+            matcher.match(event.jets, event.triggerObjects, matchResult);
+        }, events, minDuration, results);
+        karma::benchmark::printResult("StaticDeltaRThresholdMatcher (eta-phi grid)", nsPerEvent, pairsJetTriggerObject, "pair");
+        nMismatches += crossCheck("StaticDeltaRThresholdMatcher (eta-phi grid)", results, reference);
+    }
+    {
+        karma::StaticCachedDeltaRThresholdMatcher<Jets, TriggerObjects> matcher(maxDeltaR);
+        nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+            matcher.match(event.jets, event.triggerObjects, matchResult);
+        }, events, minDuration, results);
+        karma::benchmark::printResult("StaticCachedDeltaRThresholdMatcher", nsPerEvent, pairsJetTriggerObject, "pair");
+        nMismatches += crossCheck("StaticCachedDeltaRThresholdMatcher", results, reference);
+    }
+
+    // -- LowestAbsDeltaInvariantMassMatcher (jets vs. jets)
+
+    const double pairsJetJet = nJets * nJets;
+    std::cout << std::endl << "LowestAbsDeltaInvariantMassMatcher (jets x jets, maxDeltaInvariantMass = " << maxDeltaInvariantMass << ")" << std::endl;
+    {
+        const karma::AbsDeltaInvariantMassFunctor invariantMassFunctor(91.1876);
+        nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+            referenceLowestMetricMatch(event.jets, event.jets, invariantMassFunctor, maxDeltaInvariantMass, 0, false, matchResult);
+        }, events, minDuration, reference);
+        karma::benchmark::printResult("reference (metric matrix rescan)", nsPerEvent, pairsJetJet, "pair");
+    }
+    {
+        karma::LowestAbsDeltaInvariantMassMatcher<Jets> matcher(91.1876, maxDeltaInvariantMass, 0, false);
+        nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+            matchResult = matcher.match(event.jets, event.jets);
+        }, events, minDuration, results);
+        karma::benchmark::printResult("LowestAbsDeltaInvariantMassMatcher", nsPerEvent, pairsJetJet, "pair");
+        nMismatches += crossCheck("LowestAbsDeltaInvariantMassMatcher", results, reference);
+    }
+    {
+        karma::StaticLowestAbsDeltaInvariantMassMatcher<Jets> matcher(91.1876, maxDeltaInvariantMass, 0, false);
+        nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+            matcher.match(event.jets, event.jets, matchResult);
+        }, events, minDuration, results);
+        karma::benchmark::printResult("StaticLowestAbsDeltaInvariantMassMatcher", nsPerEvent, pairsJetJet, "pair");
+        nMismatches += crossCheck("StaticLowestAbsDeltaInvariantMassMatcher", results, reference);
+    }
+
+    // -- randomized comparison to the reference implementations
+
+    if (nRandomTrials > 0) {
+        std::cout << std::endl << "Comparing all matchers to the reference on " << nRandomTrials << " randomized inputs" << std::endl;
+        const int nRandomMismatches = randomizedCrossCheck(nRandomTrials, maxDeltaR, maxDeltaInvariantMass, rng);
+        if (!nRandomMismatches) {
+            std::cout << "  all results identical" << std::endl;
+        }
+        nMismatches += nRandomMismatches;
+    }
+
+    // -- scaling with the collection size (lowest DeltaR, n x n objects)
+
+    const size_t scalingSizes[] = {10, 20, 50, 100, 200, 500, 1000};
+    const size_t nScalingEvents = 5;
+    for (const size_t size : scalingSizes) {
+        if (size > maxScalingSize)
+            break;
+
+        std::vector<SyntheticEvent> scalingEvents(nScalingEvents);
+        for (auto& event : scalingEvents) {
+            fillRandomKinematics(event.jets, size, 4.7, rng);
+            fillRandomKinematics(event.triggerObjects, size, 4.7, rng);
+        }
+
+        const double pairs = size * size;
+        std::cout << std::endl << "LowestDeltaRMatcher scaling (" << size << " x " << size << " objects)" << std::endl;
+        {
+            nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+                referenceLowestMetricMatch(event.jets, event.triggerObjects, karma::DeltaRFunctor(), maxDeltaR, 0, true, matchResult);
+            }, scalingEvents, minDuration, reference);
+            karma::benchmark::printResult("reference (metric matrix rescan)", nsPerEvent, pairs, "pair");
+        }
+        {
+            karma::StaticLowestDeltaRMatcher<Jets, TriggerObjects> matcher(maxDeltaR);
+            nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+                matcher.match(event.jets, event.triggerObjects, matchResult);
+            }, scalingEvents, minDuration, results);
+            karma::benchmark::printResult("StaticLowestDeltaRMatcher", nsPerEvent, pairs, "pair");
+            nMismatches += crossCheck("StaticLowestDeltaRMatcher", results, reference);
+        }
+        {
+            karma::StaticLowestDeltaRMatcher<Jets, TriggerObjects> matcher(maxDeltaR, 0, true, /* useEtaPhiGrid = */ true);
+            nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+                matcher.match(event.jets, event.triggerObjects, matchResult);
+            }, scalingEvents, minDuration, results);
+            karma::benchmark::printResult("StaticLowestDeltaRMatcher (eta-phi grid)", nsPerEvent, pairs, "pair");
+            nMismatches += crossCheck("StaticLowestDeltaRMatcher (eta-phi grid)", results, reference);
+        }
+        {
+            karma::StaticCachedLowestDeltaRMatcher<Jets, TriggerObjects> matcher(maxDeltaR);
+            nsPerEvent = runMatcher([&](const SyntheticEvent& event, MatchResult& matchResult) {
+                matcher.match(event.jets, event.triggerObjects, matchResult);
+            }, scalingEvents, minDuration, results);
+            karma::benchmark::printResult("StaticCachedLowestDeltaRMatcher", nsPerEvent, pairs, "pair");
+            nMismatches += crossCheck("StaticCachedLowestDeltaRMatcher", results, reference);
+        }
+    }
+
+    if (nMismatches) {
+        std::cout << std::endl << "[ERROR] Cross-check failed: " << nMismatches << " mismatching result(s)!" << std::endl;
+        return 1;
+    }
+    std::cout << std::endl << "Cross-check passed: all matcher variants give the same results as the reference implementation." << std::endl;
+    return 0;
+}
@@ -0,0 +1,204 @@
+/**
+ * Standalone micro-benchmark for the transient maps of the karma data formats
+ * (see `Karma/SkimmingFormats/interface/TransientMap.h`).
+ *
+ * Fills jet collections with typical transient map contents (JEC levels and
+ * JES uncertainty factors) and compares the time needed for copying the
+ * collections (as done at each step of the JEC/JER/systematics chain) and for
+ * looking up all values, for the previous storage (`std::map` with string
+ * keys) and the flat storage with interned keys. The looked-up values are
+ * cross-checked against each other.
+ *
+ * Usage example:
+ *     karmaBenchmarkTransientMaps --nJets 20 --nDoubles 30 --nLVs 6
+ */
+
+// system include files
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "Karma/Common/interface/Tools/Benchmark.h"
+
+#include "Karma/SkimmingFormats/interface/Event.h"
+#include "Karma/SkimmingFormats/interface/TransientMap.h"
+
+
+namespace {
+
+    /** Jet with the previous transient map storage (the transient maps of `jet` are left empty) */
+    struct LegacyJet {
+        karma::Jet jet;
+        std::map<std::string, double> transientDoubles_;
+        std::map<std::string, karma::LorentzVector> transientLVs_;
+    };
+
+}  // end namespace
+
+
+int main(int argc, char** argv) {
+
+    namespace po = boost::program_options;
+
+    // -- parse command line options
+
+    size_t nJets;
+    size_t nDoubles;
+    size_t nLVs;
+    size_t nEvents;
+    unsigned int seed;
+    double minDuration;
+
+    po::options_description desc("Benchmark copying and lookups of jets with transient maps. Options");
+    desc.add_options()
+        ("help,h", "print this message")
+        ("nJets", po::value<size_t>(&nJets)->default_value(20), "number of jets per event")
+        ("nDoubles", po::value<size_t>(&nDoubles)->default_value(30), "number of entries in the transient map of doubles (e.g. JES uncertainty sources)")
+        ("nLVs", po::value<size_t>(&nLVs)->default_value(6), "number of entries in the transient map of Lorentz vectors (e.g. JEC levels)")
+        ("nEvents", po::value<size_t>(&nEvents)->default_value(100), "number of synthetic events")
+        ("seed", po::value<unsigned int>(&seed)->default_value(42), "seed for the random number generator")
+        ("minDuration", po::value<double>(&minDuration)->default_value(0.5), "minimum duration of each measurement (seconds)")
+    ;
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (const po::error& err) {
+        std::cerr << "Error: " << err.what() << std::endl << desc << std::endl;
+        return 2;
+    }
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    // -- key names (resolved once, as done in the module constructors)
+
+    std::vector<std::string> doubleKeyNames;
+    std::vector<karma::TransientKey> doubleKeys;
+    for (size_t iKey = 0; iKey < nDoubles; ++iKey) {
+        doubleKeyNames.push_back("JESUncertaintySource" + std::to_string(iKey));
+        doubleKeys.emplace_back(doubleKeyNames.back());
+    }
+    std::vector<std::string> lvKeyNames;
+    std::vector<karma::TransientKey> lvKeys;
+    for (size_t iKey = 0; iKey < nLVs; ++iKey) {
+        lvKeyNames.push_back("JECLevel" + std::to_string(iKey));
+        lvKeys.emplace_back(lvKeyNames.back());
+    }
+
+    // -- generate synthetic events
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> valueDist(0.9, 1.1);
+    std::vector<std::vector<LegacyJet>> legacyEvents(nEvents, std::vector<LegacyJet>(nJets));
+    std::vector<karma::JetCollection> events(nEvents, karma::JetCollection(nJets));
+    for (size_t iEvent = 0; iEvent < nEvents; ++iEvent) {
+        for (size_t iJet = 0; iJet < nJets; ++iJet) {
+            auto& legacyJet = legacyEvents[iEvent][iJet];
+            auto& jet = events[iEvent][iJet];
+            for (size_t iKey = 0; iKey < nDoubles; ++iKey) {
+                const double value = valueDist(rng);
+                legacyJet.transientDoubles_[doubleKeyNames[iKey]] = value;
+                jet.transientDoubles_[doubleKeys[iKey]] = value;
+            }
+            for (size_t iKey = 0; iKey < nLVs; ++iKey) {
+                const karma::LorentzVector value(20.0 * valueDist(rng), 0.0, 0.0, 5.0);
+                legacyJet.transientLVs_[lvKeyNames[iKey]] = value;
+                jet.transientLVs_[lvKeys[iKey]] = value;
+            }
+        }
+    }
+
+    std::cout << "Benchmarking transient maps on " << nEvents << " synthetic events (seed " << seed << ") with "
+              << nJets << " jets, " << nDoubles << " doubles and " << nLVs << " Lorentz vectors per jet" << std::endl;
+
+    const double nJetsTotal = nEvents * nJets;
+    const double nLookupsTotal = nJetsTotal * (nDoubles + nLVs);
+    double nsPerPass;
+
+    // -- copying
+
+    std::cout << std::endl << "Copying jet collections" << std::endl;
+    {
+        std::vector<LegacyJet> legacyCopy;
+        nsPerPass = karma::benchmark::timePerCall([&]() {
+            for (const auto& legacyEvent : legacyEvents) {
+                legacyCopy = legacyEvent;
+            }
+        }, minDuration);
+        karma::benchmark::printResult("std::map with string keys", nsPerPass, nJetsTotal, "jet");
+    }
+    {
+        karma::JetCollection copy;
+        nsPerPass = karma::benchmark::timePerCall([&]() {
+            for (const auto& event : events) {
+                copy = event;
+            }
+        }, minDuration);
+        karma::benchmark::printResult("TransientMap", nsPerPass, nJetsTotal, "jet");
+    }
+
+    // -- lookups
+
+    std::cout << std::endl << "Looking up all values" << std::endl;
+    double legacySum = 0.0;
+    double sumByName = 0.0;
+    double sumByKey = 0.0;
+    auto lookUpAll = [&](const auto& transientDoubles, const auto& transientLVs, const auto& doubleKeysOrNames, const auto& lvKeysOrNames) {
+        double sum = 0.0;
+        for (const auto& key : doubleKeysOrNames) {
+            sum += transientDoubles.at(key);
+        }
+        for (const auto& key : lvKeysOrNames) {
+            sum += transientLVs.at(key).pt();
+        }
+        return sum;
+    };
+
+    nsPerPass = karma::benchmark::timePerCall([&]() {
+        legacySum = 0.0;
+        for (const auto& legacyEvent : legacyEvents) {
+            for (const auto& legacyJet : legacyEvent) {
+                legacySum += lookUpAll(legacyJet.transientDoubles_, legacyJet.transientLVs_, doubleKeyNames, lvKeyNames);
+            }
+        }
+    }, minDuration);
+    karma::benchmark::printResult("std::map with string keys", nsPerPass, nLookupsTotal, "lookup");
+
+    nsPerPass = karma::benchmark::timePerCall([&]() {
+        sumByName = 0.0;
+        for (const auto& event : events) {
+            for (const auto& jet : event) {
+                sumByName += lookUpAll(jet.transientDoubles_, jet.transientLVs_, doubleKeyNames, lvKeyNames);
+            }
+        }
+    }, minDuration);
+    karma::benchmark::printResult("TransientMap (by name)", nsPerPass, nLookupsTotal, "lookup");
+
+    nsPerPass = karma::benchmark::timePerCall([&]() {
+        sumByKey = 0.0;
+        for (const auto& event : events) {
+            for (const auto& jet : event) {
+                sumByKey += lookUpAll(jet.transientDoubles_, jet.transientLVs_, doubleKeys, lvKeys);
+            }
+        }
+    }, minDuration);
+    karma::benchmark::printResult("TransientMap (by interned key)", nsPerPass, nLookupsTotal, "lookup");
+
+    // -- cross-check
+
+    if ((sumByName != legacySum) || (sumByKey != legacySum)) {
+        std::cout << std::endl << "[ERROR] Cross-check failed: looked-up values differ ("
+                  << legacySum << ", " << sumByName << ", " << sumByKey << ")!" << std::endl;
+        return 1;
+    }
+    std::cout << std::endl << "Cross-check passed: all storages give identical values." << std::endl;
+    return 0;
+}
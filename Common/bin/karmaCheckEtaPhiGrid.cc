@@ -0,0 +1,248 @@
+/**
+ * Standalone check of the eta-phi grid used by the DeltaR matchers
+ * (see `karma::EtaPhiGrid` in `Karma/Common/interface/Tools/Matchers.h`).
+ *
+ * Generates random primary and secondary collections and checks that:
+ *   - the candidates returned by the grid contain every secondary element
+ *     within the cell size (in DeltaR) of the query point, in ascending order
+ *     and without duplicates,
+ *   - the number of grid cells stays limited relative to the number of
+ *     bucketed elements, also for very small cell sizes,
+ *   - the DeltaR matchers give identical results with and without the grid.
+ *
+ * The inputs cover small and large DeltaR values, small and large collections,
+ * elements close to the phi boundary and at extreme or non-finite eta/phi.
+ *
+ * Returns a non-zero exit code if any of the checks fails.
+ *
+ * Usage example:
+ *     karmaCheckEtaPhiGrid --nTrials 50 --seed 42
+ */
+
+// system include files
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "Karma/Common/interface/Tools/Matchers.h"
+
+#include "Karma/SkimmingFormats/interface/Event.h"
+
+
+namespace {
+
+    typedef std::vector<std::pair<int, int>> MatchResult;
+
+    /** Print the outcome of a single check and count failures */
+    class Checker {
+      public:
+        void check(bool passed, const std::string& description) {
+            std::cout << "  " << (passed ? "[OK]    " : "[ERROR] ") << description << std::endl;
+            if (!passed)
+                ++nFailed_;
+        }
+
+        size_t nFailed() const { return nFailed_; }
+
+      private:
+        size_t nFailed_ = 0;
+    };
+
+    /** Kind of input collections to generate */
+    enum class InputKind {
+        Uniform,        // uniform in |eta| < 5 and phi
+        PhiBoundary,    // phi close to +/- pi
+        Clustered,      // few clusters, many exact duplicates
+        Extreme,        // extreme and non-finite eta/phi mixed in
+    };
+
+    /** Fill the kinematics of `collection` with `n` random objects of the given kind */
+    template<typename TCollection>
+    void fillRandomKinematics(TCollection& collection, size_t n, InputKind kind, std::mt19937& rng) {
+        std::uniform_real_distribution<double> etaDist(-5.0, 5.0);
+        std::uniform_real_distribution<double> phiDist(-M_PI, M_PI);
+        std::uniform_real_distribution<double> phiBoundaryDist(-0.05, 0.05);
+        std::uniform_int_distribution<int> clusterDist(0, 3);
+        std::uniform_int_distribution<int> extremeDist(0, 9);
+
+        collection.resize(n);
+        for (auto& object : collection) {
+            double eta = etaDist(rng);
+            double phi = phiDist(rng);
+            if (kind == InputKind::PhiBoundary) {
+                // just below +pi or just above -pi
+                const double dPhi = phiBoundaryDist(rng);
+                phi = (dPhi > 0) ? (M_PI - dPhi) : (-M_PI - dPhi);
+            }
+            else if (kind == InputKind::Clustered) {
+                const int iCluster = clusterDist(rng);
+                eta = 0.5 * iCluster;
+                phi = (iCluster % 2) ? M_PI - 1e-12 : -M_PI + 1e-12;
+            }
+            else if (kind == InputKind::Extreme) {
+                switch (extremeDist(rng)) {
+                    case 0: eta = 1e3; break;
+                    case 1: eta = -1e3; break;
+                    case 2: eta = std::numeric_limits<double>::quiet_NaN(); break;
+                    case 3: phi = std::numeric_limits<double>::infinity(); break;
+                    default: break;
+                }
+            }
+            object.p4 = karma::LorentzVector(30.0, eta, phi, 5.0);
+        }
+    }
+
+    /** Name of an input kind for printing */
+    std::string inputKindName(InputKind kind) {
+        switch (kind) {
+            case InputKind::Uniform: return "uniform";
+            case InputKind::PhiBoundary: return "phi boundary";
+            case InputKind::Clustered: return "clustered";
+            case InputKind::Extreme: return "extreme eta/phi";
+        }
+        return "";
+    }
+
+    /**
+     * Check the candidates of the grid against a scan of all secondaries. Returns the number
+     * of query points for which a secondary within `cellSize` is missing, or the candidates
+     * are not strictly ascending. The number of grid cells is written to `nCells`.
+     */
+    template<typename TPrimaryCollection, typename TSecondaryCollection>
+    size_t checkCandidates(const TPrimaryCollection& primaries, const TSecondaryCollection& secondaries, double cellSize, int& nCells) {
+
+        karma::EtaPhiGrid grid(cellSize);
+
+        // use a large number of queries so that the grid is not skipped for small collections
+        nCells = 0;
+        if (!grid.fill(secondaries, std::numeric_limits<size_t>::max() / (secondaries.size() + 1)))
+            return 0;
+        nCells = grid.numCells();
+
+        size_t nBadQueries = 0;
+        std::vector<size_t> candidates;
+        for (const auto& primary : primaries) {
+            grid.getCandidates(primary.p4, candidates);
+
+            bool good = true;
+            for (size_t iCandidate = 1; iCandidate < candidates.size(); ++iCandidate) {
+                good = good && (candidates[iCandidate - 1] < candidates[iCandidate]);
+            }
+
+            size_t iCandidate = 0;
+            for (size_t iSecondary = 0; iSecondary < secondaries.size(); ++iSecondary) {
+                while ((iCandidate < candidates.size()) && (candidates[iCandidate] < iSecondary))
+                    ++iCandidate;
+                const bool isCandidate = (iCandidate < candidates.size()) && (candidates[iCandidate] == iSecondary);
+                // note: 'nan' values fail the comparison and need not be candidates
+                if (!isCandidate && (karma::DeltaRFunctor()(primary.p4, secondaries[iSecondary].p4) <= cellSize))
+                    good = false;
+            }
+            if (!good)
+                ++nBadQueries;
+        }
+        return nBadQueries;
+    }
+
+}  // end namespace
+
+
+int main(int argc, char** argv) {
+
+    namespace po = boost::program_options;
+
+    // -- parse command line options
+
+    size_t nTrials;
+    unsigned int seed;
+
+    po::options_description desc("Check the eta-phi grid of the DeltaR matchers against brute force. Options");
+    desc.add_options()
+        ("help,h", "print this message")
+        ("nTrials", po::value<size_t>(&nTrials)->default_value(50), "number of random inputs per configuration")
+        ("seed", po::value<unsigned int>(&seed)->default_value(42), "seed for the random number generator")
+    ;
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (const po::error& err) {
+        std::cerr << "Error: " << err.what() << std::endl << desc << std::endl;
+        return 2;
+    }
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    std::mt19937 rng(seed);
+    Checker checker;
+
+    const std::vector<double> maxDeltaRs = {1e-4, 0.001, 0.1, 0.4, 1.0, 3.5, 10.0};
+    const std::vector<std::pair<size_t, size_t>> sizes = {{0, 5}, {5, 0}, {1, 1}, {10, 10}, {20, 300}, {50, 500}};
+    const std::vector<InputKind> inputKinds = {InputKind::Uniform, InputKind::PhiBoundary, InputKind::Clustered, InputKind::Extreme};
+
+    karma::JetCollection primaries;
+    karma::TriggerObjectCollection secondaries;
+    MatchResult resultBruteForce;
+    MatchResult resultGrid;
+
+    for (const auto inputKind : inputKinds) {
+        std::cout << "inputs: " << inputKindName(inputKind) << std::endl;
+
+        for (const double maxDeltaR : maxDeltaRs) {
+            for (const auto& size : sizes) {
+
+                // -- matchers with and without grid (also disallowing identical indices and limiting matches)
+                karma::StaticLowestDeltaRMatcher<karma::JetCollection, karma::TriggerObjectCollection> lowestBruteForce(maxDeltaR, 0, false);
+                karma::StaticLowestDeltaRMatcher<karma::JetCollection, karma::TriggerObjectCollection> lowestGrid(maxDeltaR, 0, false, /* useEtaPhiGrid = */ true);
+                karma::StaticDeltaRThresholdMatcher<karma::JetCollection, karma::TriggerObjectCollection> thresholdBruteForce(maxDeltaR, 7, true);
+                karma::StaticDeltaRThresholdMatcher<karma::JetCollection, karma::TriggerObjectCollection> thresholdGrid(maxDeltaR, 7, true, /* useEtaPhiGrid = */ true);
+
+                size_t nMismatches = 0;
+                size_t nBadQueries = 0;
+                int maxCellsPerElement = 0;
+                for (size_t iTrial = 0; iTrial < nTrials; ++iTrial) {
+                    fillRandomKinematics(primaries, size.first, inputKind, rng);
+                    fillRandomKinematics(secondaries, size.second, inputKind, rng);
+
+                    lowestBruteForce.match(primaries, secondaries, resultBruteForce);
+                    lowestGrid.match(primaries, secondaries, resultGrid);
+                    nMismatches += (resultGrid != resultBruteForce);
+
+                    thresholdBruteForce.match(primaries, secondaries, resultBruteForce);
+                    thresholdGrid.match(primaries, secondaries, resultGrid);
+                    nMismatches += (resultGrid != resultBruteForce);
+
+                    int nCells = 0;
+                    nBadQueries += checkCandidates(primaries, secondaries, maxDeltaR, nCells);
+                    // cells are limited to two per element
+                    if (size.second > 0)
+                        maxCellsPerElement = std::max(maxCellsPerElement, static_cast<int>(std::ceil(double(nCells) / size.second)));
+                }
+
+                const std::string configuration = "maxDeltaR = " + std::to_string(maxDeltaR) + ", "
+                    + std::to_string(size.first) + " x " + std::to_string(size.second) + ": ";
+                checker.check(nMismatches == 0, configuration + "matcher results identical to brute force (mismatches: " + std::to_string(nMismatches) + ")");
+                checker.check(nBadQueries == 0, configuration + "grid candidates complete and sorted (bad queries: " + std::to_string(nBadQueries) + ")");
+                checker.check(maxCellsPerElement <= 2, configuration + "number of cells limited (max. " + std::to_string(maxCellsPerElement) + " per element)");
+            }
+        }
+    }
+
+    // -- summary
+
+    if (checker.nFailed()) {
+        std::cout << std::endl << "[ERROR] " << checker.nFailed() << " check(s) failed!" << std::endl;
+        return 1;
+    }
+    std::cout << std::endl << "All checks passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,214 @@
+/**
+ * Standalone check of the memoization in `karma::TriggerMenuRegistry`
+ * (see `Karma/Common/interface/Tools/TriggerMenuRegistry.h`).
+ *
+ * Calls `matchPaths` and `resolvePaths` repeatedly for a synthetic trigger
+ * menu and checks the cache statistics: a repeated call with the same menu
+ * name and configuration must be a cache hit returning the same result,
+ * while a changed list of paths (under the same menu name), a different menu
+ * name or a different configuration must be a cache miss. The returned
+ * results are compared to the expected path indices and names. Finally,
+ * the same call is made concurrently from several threads, which must
+ * result in exactly one cache miss.
+ *
+ * Returns a non-zero exit code if any of the checks fails.
+ *
+ * Usage example:
+ *     karmaCheckTriggerMenuRegistry --nThreads 8
+ */
+
+// system include files
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "Karma/Common/interface/Tools/TriggerMenuRegistry.h"
+
+
+namespace {
+
+    /** Cache statistics of the registry at a given point */
+    struct CacheCounts {
+        size_t hits;
+        size_t misses;
+    };
+
+    CacheCounts getCacheCounts() {
+        const auto& registry = karma::TriggerMenuRegistry::instance();
+        return {registry.numCacheHits(), registry.numCacheMisses()};
+    }
+
+    /** Print the outcome of a single check and count failures */
+    class Checker {
+      public:
+        void check(bool passed, const std::string& description) {
+            std::cout << "  " << (passed ? "[OK]    " : "[ERROR] ") << description << std::endl;
+            if (!passed)
+                ++nFailed_;
+        }
+
+        /** Check the change in cache statistics since `before` */
+        void checkCacheCounts(const CacheCounts& before, size_t expectedHits, size_t expectedMisses, const std::string& description) {
+            const CacheCounts after = getCacheCounts();
+            const size_t nHits = after.hits - before.hits;
+            const size_t nMisses = after.misses - before.misses;
+            check(
+                (nHits == expectedHits) && (nMisses == expectedMisses),
+                description + " (hits: " + std::to_string(nHits) + ", misses: " + std::to_string(nMisses) + ")");
+        }
+
+        size_t nFailed() const { return nFailed_; }
+
+      private:
+        size_t nFailed_ = 0;
+    };
+
+}  // end namespace
+
+
+int main(int argc, char** argv) {
+
+    namespace po = boost::program_options;
+
+    // -- parse command line options
+
+    size_t nThreads;
+
+    po::options_description desc("Check the memoization in the trigger menu registry. Options");
+    desc.add_options()
+        ("help,h", "print this message")
+        ("nThreads", po::value<size_t>(&nThreads)->default_value(8), "number of threads for the concurrent lookup check")
+    ;
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (const po::error& err) {
+        std::cerr << "Error: " << err.what() << std::endl << desc << std::endl;
+        return 2;
+    }
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    auto& registry = karma::TriggerMenuRegistry::instance();
+    Checker checker;
+
+    // -- synthetic trigger menu and module configuration
+
+    const std::string menuName = "/cdaq/physics/Run2016/25ns15e33/v4.2.3/HLT/V2";
+    const std::vector<std::string> pathNames = {
+        "HLTriggerFirstPath",
+        "HLT_PFJet40_v11",
+        "HLT_PFJet450_v12",
+        "HLT_AK8PFJet80_v5",
+        "HLT_DiPFJetAve60_v7",
+        "HLT_IsoMu24_v4",
+        "HLTriggerFinalPath",
+    };
+    const std::vector<std::string> regexes = {"HLT_(AK8)?PFJet[0-9]+_v[0-9]+", "HLT_DiPFJetAve[0-9]+_v[0-9]+"};
+    const std::vector<std::string> requestedPaths = {"HLT_DiPFJetAve60", "HLT_PFJet40", "HLT_PFJet450"};
+
+    // menu with the same name, but a changed list of paths (one path added, one version changed)
+    std::vector<std::string> changedPathNames = pathNames;
+    changedPathNames[1] = "HLT_PFJet40_v12";
+    changedPathNames.insert(changedPathNames.begin() + 3, "HLT_PFJet500_v12");
+
+    // -- matchPaths
+
+    std::cout << "matchPaths:" << std::endl;
+    {
+        CacheCounts before = getCacheCounts();
+        const auto matched = registry.matchPaths(menuName, pathNames, regexes);
+        checker.checkCacheCounts(before, 0, 1, "first call is a cache miss");
+        checker.check(*matched == std::vector<size_t>({1, 2, 3, 4}), "matched path indices are correct");
+
+        before = getCacheCounts();
+        const auto matchedAgain = registry.matchPaths(menuName, pathNames, regexes);
+        checker.checkCacheCounts(before, 1, 0, "repeated call with same menu is a cache hit");
+        checker.check(matchedAgain == matched, "repeated call returns the memoized result");
+
+        before = getCacheCounts();
+        const auto matchedChanged = registry.matchPaths(menuName, changedPathNames, regexes);
+        checker.checkCacheCounts(before, 0, 1, "changed path list under same menu name is a cache miss");
+        checker.check(*matchedChanged == std::vector<size_t>({1, 2, 3, 4, 5}), "matched path indices for changed path list are correct");
+
+        before = getCacheCounts();
+        registry.matchPaths(menuName + "_other", changedPathNames, regexes);
+        checker.checkCacheCounts(before, 0, 1, "different menu name is a cache miss");
+
+        before = getCacheCounts();
+        const auto matchedOtherRegexes = registry.matchPaths(menuName, changedPathNames, {"HLT_DiPFJetAve[0-9]+_v[0-9]+"});
+        checker.checkCacheCounts(before, 0, 1, "different regexes are a cache miss");
+        checker.check(*matchedOtherRegexes == std::vector<size_t>({5}), "matched path indices for different regexes are correct");
+    }
+
+    // -- resolvePaths
+
+    std::cout << "resolvePaths:" << std::endl;
+    {
+        CacheCounts before = getCacheCounts();
+        const auto resolved = registry.resolvePaths(menuName, pathNames, requestedPaths);
+        checker.checkCacheCounts(before, 0, 1, "first call is a cache miss");
+        checker.check(
+            resolved->unversionedNames == std::vector<std::string>({"", "HLT_PFJet40", "HLT_PFJet450", "HLT_AK8PFJet80", "HLT_DiPFJetAve60", "HLT_IsoMu24", ""}),
+            "unversioned path names are correct");
+        checker.check(resolved->indicesInConfig == std::vector<int>({-1, 1, 2, -1, 0, -1, -1}), "indices in config are correct");
+
+        before = getCacheCounts();
+        const auto resolvedAgain = registry.resolvePaths(menuName, pathNames, requestedPaths);
+        checker.checkCacheCounts(before, 1, 0, "repeated call with same menu is a cache hit");
+        checker.check(resolvedAgain == resolved, "repeated call returns the memoized result");
+
+        before = getCacheCounts();
+        const auto resolvedChanged = registry.resolvePaths(menuName, changedPathNames, requestedPaths);
+        checker.checkCacheCounts(before, 0, 1, "changed path list under same menu name is a cache miss");
+        checker.check(resolvedChanged->indicesInConfig == std::vector<int>({-1, 1, 2, -1, -1, 0, -1, -1}), "indices in config for changed path list are correct");
+
+        before = getCacheCounts();
+        registry.resolvePaths(menuName, changedPathNames, {"HLT_IsoMu24"});
+        checker.checkCacheCounts(before, 0, 1, "different requested paths are a cache miss");
+    }
+
+    // -- concurrent lookups (as in `globalBeginRun` of several modules)
+
+    std::cout << "concurrent resolvePaths (" << nThreads << " threads):" << std::endl;
+    {
+        const std::string concurrentMenuName = menuName + "_concurrent";
+        std::vector<std::shared_ptr<const karma::ResolvedTriggerPaths>> results(nThreads);
+        std::vector<std::thread> threads;
+
+        const CacheCounts before = getCacheCounts();
+        for (size_t iThread = 0; iThread < nThreads; ++iThread) {
+            threads.emplace_back([&, iThread]() {
+                results[iThread] = registry.resolvePaths(concurrentMenuName, pathNames, requestedPaths);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        checker.checkCacheCounts(before, nThreads - 1, 1, "exactly one cache miss");
+
+        bool allSame = true;
+        for (const auto& result : results) {
+            allSame = allSame && (result == results.front());
+        }
+        checker.check(allSame, "all threads get the same result");
+    }
+
+    // -- summary
+
+    if (checker.nFailed()) {
+        std::cout << std::endl << "[ERROR] " << checker.nFailed() << " check(s) failed!" << std::endl;
+        return 1;
+    }
+    std::cout << std::endl << "All checks passed." << std::endl;
+    return 0;
+}
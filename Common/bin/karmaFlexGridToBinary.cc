@@ -0,0 +1,167 @@
+/**
+ * Convert a FlexGrid binning scheme from YAML to the binary format of
+ * `karma::FlexGridTables` (see `Karma/Common/interface/Providers/FlexGridTables.h`),
+ * which can be memory-mapped read-only instead of parsing the YAML file.
+ *
+ * Metadata keys to be stored as typed columns are given with `--intColumn` and
+ * `--doubleColumn` (subkeys separated by '.', option can be repeated).
+ *
+ * With `--verify`, the written file is mapped again and the bin indices and
+ * metadata columns are compared to the YAML-loaded grid for the bin edges,
+ * bin centers and out-of-range values of every node. Exits with a nonzero
+ * status if any mismatch is found.
+ *
+ * Usage example:
+ *     karmaFlexGridToBinary --input flexgrid_ys_yb_ptave_AK4PFCHS.yml --output flexgrid_ys_yb_ptave_AK4PFCHS.bin \
+ *                           --intColumn someIntKey --verify
+ */
+
+// system include files
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "Karma/Common/interface/Providers/FlexGridBinProvider.h"
+#include "Karma/Common/interface/Providers/FlexGridTables.h"
+
+
+namespace {
+
+    /**
+     * Collect test value tuples by descending the node tree: at each level, use
+     * all bin edges, all bin centers and one value below and above the range.
+     * Values inside a bin are followed into the corresponding subnode.
+     */
+    void collectTestValues(const FlexNode& node, std::vector<double>& prefix, std::vector<std::vector<double>>& valueTuples) {
+        const auto& bins = node.getBins();
+
+        std::vector<double> testValues(bins.begin(), bins.end());
+        for (size_t iBin = 0; iBin + 1 < bins.size(); ++iBin) {
+            testValues.push_back(0.5 * (bins[iBin] + bins[iBin + 1]));
+        }
+        testValues.push_back(bins.front() - 1.0);
+        testValues.push_back(bins.back() + 1.0);
+
+        for (const double value : testValues) {
+            prefix.push_back(value);
+            const auto nextIter = std::upper_bound(bins.begin(), bins.end(), value);
+            if (node.hasSubstructure() && (nextIter != bins.begin()) && (nextIter != bins.end())) {
+                collectTestValues(node.getSubnode(std::distance(bins.begin(), nextIter) - 1), prefix, valueTuples);
+            }
+            else if (!node.hasSubstructure()) {
+                valueTuples.push_back(prefix);
+            }
+            prefix.pop_back();
+        }
+    }
+
+    /** Compare two metadata columns (`nan` values are considered equal) */
+    template <typename T>
+    int countMismatches(const std::vector<T>& expected, const T* actual) {
+        int nMismatches = 0;
+        for (size_t iBin = 0; iBin < expected.size(); ++iBin) {
+            const bool bothNan = std::isnan(double(expected[iBin])) && std::isnan(double(actual[iBin]));
+            if (!bothNan && (expected[iBin] != actual[iBin])) {
+                ++nMismatches;
+            }
+        }
+        return nMismatches;
+    }
+
+}  // end namespace
+
+
+int main(int argc, char** argv) {
+
+    namespace po = boost::program_options;
+
+    // -- parse command line options
+
+    std::string inputFile;
+    std::string outputFile;
+    std::vector<std::string> intColumns;
+    std::vector<std::string> doubleColumns;
+    int intMissingValue;
+
+    po::options_description desc("Convert a FlexGrid from YAML to binary format. Options");
+    desc.add_options()
+        ("help,h", "print this message")
+        ("input,i", po::value<std::string>(&inputFile)->required(), "YAML file containing the FlexGrid binning")
+        ("output,o", po::value<std::string>(&outputFile)->required(), "binary output file")
+        ("intColumn", po::value<std::vector<std::string>>(&intColumns)->composing(), "metadata key to store as `int` column (can be repeated)")
+        ("doubleColumn", po::value<std::vector<std::string>>(&doubleColumns)->composing(), "metadata key to store as `double` column (can be repeated)")
+        ("intMissingValue", po::value<int>(&intMissingValue)->default_value(-1), "value of `int` columns for bins without metadata (`double` columns: nan)")
+        ("verify", "map the output file and compare it to the YAML-loaded grid")
+    ;
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help")) {
+            std::cout << desc << std::endl;
+            return 0;
+        }
+        po::notify(vm);
+    }
+    catch (const po::error& err) {
+        std::cerr << "Error: " << err.what() << std::endl << desc << std::endl;
+        return 2;
+    }
+
+    // -- convert
+
+    const FlexGrid flexGrid(inputFile);
+    flexGrid.compileTables(intColumns, doubleColumns, intMissingValue).writeFile(outputFile);
+
+    std::cout << "Wrote FlexGrid with " << flexGrid.numBins() << " bins, " << intColumns.size() << " int and "
+              << doubleColumns.size() << " double metadata column(s) to file: " << outputFile << std::endl;
+
+    if (!vm.count("verify")) {
+        return 0;
+    }
+
+    // -- verify round trip
+
+    const karma::FlexGridTables mappedTables = karma::FlexGridTables::mapFile(outputFile);
+
+    int nMismatches = 0;
+    if (mappedTables.numBins() != flexGrid.numBins()) {
+        std::cout << "[ERROR] Number of bins differs: " << mappedTables.numBins() << " != " << flexGrid.numBins() << std::endl;
+        ++nMismatches;
+    }
+
+    std::vector<double> prefix;
+    std::vector<std::vector<double>> valueTuples;
+    collectTestValues(flexGrid._rootFlexNode, prefix, valueTuples);
+    int nIndexMismatches = 0;
+    for (const auto& values : valueTuples) {
+        if (mappedTables.findIndex(values.data(), values.size()) != flexGrid.findIndexInTree(values)) {
+            ++nIndexMismatches;
+        }
+    }
+    std::cout << "Compared bin indices for " << valueTuples.size() << " value tuples: " << nIndexMismatches << " mismatch(es)" << std::endl;
+    nMismatches += nIndexMismatches;
+
+    for (const auto& keySpec : intColumns) {
+        const int32_t* column = mappedTables.getIntColumn(keySpec);
+        const int nColumnMismatches = column ? countMismatches(flexGrid.makeMetadataColumn<int>(keySpec, intMissingValue), column) : 1;
+        std::cout << "Compared int column '" << keySpec << "': " << nColumnMismatches << " mismatch(es)" << std::endl;
+        nMismatches += nColumnMismatches;
+    }
+    for (const auto& keySpec : doubleColumns) {
+        const double* column = mappedTables.getDoubleColumn(keySpec);
+        const int nColumnMismatches = column ? countMismatches(flexGrid.makeMetadataColumn<double>(keySpec, std::numeric_limits<double>::quiet_NaN()), column) : 1;
+        std::cout << "Compared double column '" << keySpec << "': " << nColumnMismatches << " mismatch(es)" << std::endl;
+        nMismatches += nColumnMismatches;
+    }
+
+    if (nMismatches) {
+        std::cout << std::endl << "[ERROR] Verification failed: " << nMismatches << " mismatch(es)!" << std::endl;
+        return 1;
+    }
+    std::cout << std::endl << "Verification passed: binary and YAML-loaded grids are identical." << std::endl;
+    return 0;
+}
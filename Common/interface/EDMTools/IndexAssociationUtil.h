@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>
+
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/Ref.h"
+#include "DataFormats/Common/interface/RefProd.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+
+#include "Karma/SkimmingFormats/interface/IndexAssociation.h"
+
+
+namespace karma {
+    namespace util {
+
+        /**
+         * Convert a `karma::IndexAssociation` to an association product with
+         * `edm::Ref`s (e.g. `edm::AssociationMap`), for consumers which have not
+         * yet been migrated to the index-based product.
+         * The handles must refer to the collections used to produce the association,
+         * otherwise an exception is thrown.
+         */
+        template<typename TProduct, typename TPrimaryCollection, typename TSecondaryCollection>
+        std::unique_ptr<TProduct> makeAssociationMap(
+            const karma::IndexAssociation& indexAssociation,
+            const edm::Handle<TPrimaryCollection>& primaryCollectionHandle,
+            const edm::Handle<TSecondaryCollection>& secondaryCollectionHandle) {
+
+            // -- check that the indices refer to the collections provided
+            if (indexAssociation.primaryProductId != primaryCollectionHandle.id()) {
+                edm::Exception exception(edm::errors::LogicError);
+                exception << "[makeAssociationMap] Primary collection (product ID " << primaryCollectionHandle.id()
+                          << ") is not the one used to produce the IndexAssociation (product ID " << indexAssociation.primaryProductId << ")!";
+                throw exception;
+            }
+            if (indexAssociation.secondaryProductId != secondaryCollectionHandle.id()) {
+                edm::Exception exception(edm::errors::LogicError);
+                exception << "[makeAssociationMap] Secondary collection (product ID " << secondaryCollectionHandle.id()
+                          << ") is not the one used to produce the IndexAssociation (product ID " << indexAssociation.secondaryProductId << ")!";
+                throw exception;
+            }
+            if (indexAssociation.numPrimaries() != primaryCollectionHandle->size()) {
+                edm::Exception exception(edm::errors::LogicError);
+                exception << "[makeAssociationMap] IndexAssociation has " << indexAssociation.numPrimaries()
+                          << " primaries, but the primary collection has " << primaryCollectionHandle->size() << " elements!";
+                throw exception;
+            }
+
+            // create new TProduct (note: needs to provide constructor from RefProds)
+            std::unique_ptr<TProduct> product(new TProduct(
+                edm::RefProd<TPrimaryCollection>(primaryCollectionHandle),
+                edm::RefProd<TSecondaryCollection>(secondaryCollectionHandle)
+            ));
+
+            for (size_t iPrimary = 0; iPrimary < indexAssociation.numPrimaries(); ++iPrimary) {
+                for (unsigned int iEntry = indexAssociation.offsets[iPrimary]; iEntry < indexAssociation.offsets[iPrimary + 1]; ++iEntry) {
+                    product->insert(
+                        edm::Ref<TPrimaryCollection>(primaryCollectionHandle, iPrimary),
+                        edm::Ref<TSecondaryCollection>(secondaryCollectionHandle, indexAssociation.secondaryIndices[iEntry])
+                    );
+                }
+            }
+
+            return product;
+        }
+    }
+}
@@ -51,7 +51,7 @@ namespace karma {
         const edm::ParameterSet& m_configPSet;
         const double typeICorrectionMinJetPt_;
         const double typeICorrectionMaxTotalEMFraction_;
-        const std::string typeICorrectionJECReferenceLevel_;
+        const karma::TransientKey typeICorrectionJECReferenceLevel_;
 
         // -- handles and tokens
         typename edm::Handle<karma::Event> karmaEventHandle;
@@ -140,8 +140,14 @@ namespace karma {
 
         std::vector<std::unique_ptr<JetCorrectionUncertainty>> m_jetUncertaintySourceCorrectors;
         std::vector<std::string> m_jetUncertaintySourceNames;
+        std::vector<karma::TransientKey> m_jetUncertaintySourceKeys;
         std::vector<double> m_jetUncertaintySourceShifts;
 
+        // keys for the transient maps (resolved once)
+        const karma::TransientKey m_transientKeyL1{"L1"};
+        const karma::TransientKey m_transientKeyL1RC{"L1RC"};
+        const karma::TransientKey m_transientKeyTotal{"Total"};
+
         // -- handles and tokens
         typename edm::Handle<karma::Event> karmaEventHandle;
         edm::EDGetTokenT<karma::Event> karmaEventToken;
@@ -14,6 +14,7 @@
 #include "FWCore/Utilities/interface/StreamID.h"
 
 #include "Karma/Common/interface/EDMTools/Util.h"
+#include "Karma/SkimmingFormats/interface/IndexAssociation.h"
 
 // -- output data formats
 #include "DataFormats/Common/interface/Ref.h"
@@ -26,6 +27,19 @@ namespace karma {
 
     // -- generic producer template
 
+    /**
+     * Template for a producer which matches the elements of two collections
+     * and stores the result in an association product.
+     *
+     * 'Matcher' must provide a method `match(primary, secondary, result)`
+     * which writes the matched index pairs to `result` (see the static
+     * matchers in `Karma/Common/interface/Tools/Matchers.h`).
+     *
+     * If `produceIndexAssociation` is set, a `karma::IndexAssociation` with
+     * the matched indices and metric values is produced in addition. For this,
+     * 'Matcher' must also provide `metricValue(primaryElement, secondaryElement)`.
+     */
+
     template<typename TPrimaryCollection,
              typename TSecondaryCollection,
              typename Matcher,
@@ -39,10 +53,14 @@ namespace karma {
             m_configPSet(config),
             m_matcher(new Matcher(matcherParams...)) {
 
+            // -- process configuration
+            m_produceIndexAssociation = m_configPSet.getParameter<bool>("produceIndexAssociation");
+
             // -- register products
             produces<TProduct>();
-
-            // -- process configuration
+            if (m_produceIndexAssociation) {
+                produces<karma::IndexAssociation>();
+            }
 
             // -- declare which collections are consumed and create tokens
             primaryCollectionToken = consumes<TPrimaryCollection>(m_configPSet.getParameter<edm::InputTag>("primaryCollectionSrc"));
@@ -73,12 +91,11 @@ namespace karma {
                 edm::RefProd<TSecondaryCollection>(this->secondaryCollectionHandle)
             ));
 
-            // let the external matcher perform the matching
-            const std::vector<std::pair<int, int>> matchResults(
-                m_matcher->match(*this->primaryCollectionHandle, *this->secondaryCollectionHandle));
+            // let the external matcher perform the matching (result buffer is reused between events)
+            m_matcher->match(*this->primaryCollectionHandle, *this->secondaryCollectionHandle, m_matchResults);
 
             // commit the match results to the product
-            for (const auto& matchedIndexPair : matchResults) {
+            for (const auto& matchedIndexPair : m_matchResults) {
                 product->insert(
                     edm::Ref<TPrimaryCollection>(this->primaryCollectionHandle, matchedIndexPair.first),
                     edm::Ref<TSecondaryCollection>(this->secondaryCollectionHandle, matchedIndexPair.second)
@@ -87,6 +104,24 @@ namespace karma {
 
             // move outputs to event tree
             event.put(std::move(product));
+
+            // -- optionally store the match results as a compact index-based association
+            if (m_produceIndexAssociation) {
+                m_matchMetricValues.clear();
+                for (const auto& matchedIndexPair : m_matchResults) {
+                    m_matchMetricValues.push_back(m_matcher->metricValue(
+                        (*this->primaryCollectionHandle)[matchedIndexPair.first],
+                        (*this->secondaryCollectionHandle)[matchedIndexPair.second]
+                    ));
+                }
+
+                std::unique_ptr<karma::IndexAssociation> indexAssociation(new karma::IndexAssociation());
+                indexAssociation->fill(
+                    this->primaryCollectionHandle.id(), this->secondaryCollectionHandle.id(),
+                    this->primaryCollectionHandle->size(), m_matchResults, m_matchMetricValues
+                );
+                event.put(std::move(indexAssociation));
+            }
         };
 
 
@@ -97,6 +132,10 @@ namespace karma {
         const edm::ParameterSet& m_configPSet;
 
         std::unique_ptr<Matcher> m_matcher;
+        std::vector<std::pair<int, int>> m_matchResults;
+        std::vector<double> m_matchMetricValues;
+
+        bool m_produceIndexAssociation;
 
         // -- handles and tokens
 
@@ -34,10 +34,10 @@ namespace karma {
 
     // -- matchers
 
-    typedef karma::DeltaRThresholdMatcher<karma::JetCollection, karma::TriggerObjectCollection> JetTriggerObjectMatcher;
-    typedef karma::DeltaRThresholdMatcher<karma::JetCollection, karma::MuonCollection> JetMuonMatcher;
-    typedef karma::DeltaRThresholdMatcher<karma::JetCollection, karma::ElectronCollection> JetElectronMatcher;
-    typedef karma::LowestDeltaRMatcher<karma::JetCollection, karma::LVCollection> JetLVMatcher;
+    typedef karma::StaticDeltaRThresholdMatcher<karma::JetCollection, karma::TriggerObjectCollection> JetTriggerObjectMatcher;
+    typedef karma::StaticDeltaRThresholdMatcher<karma::JetCollection, karma::MuonCollection> JetMuonMatcher;
+    typedef karma::StaticDeltaRThresholdMatcher<karma::JetCollection, karma::ElectronCollection> JetElectronMatcher;
+    typedef karma::StaticLowestDeltaRMatcher<karma::JetCollection, karma::LVCollection> JetLVMatcher;
 
     // -- main producers
 
@@ -55,7 +55,12 @@ namespace karma {
                 karma::JetCollection,
                 karma::TriggerObjectCollection,
                 JetTriggerObjectMatcher,
-                edm::OneToMany<karma::JetCollection, karma::TriggerObjectCollection>>(config, config.getParameter<double>("maxDeltaR")) {};
+                edm::OneToMany<karma::JetCollection, karma::TriggerObjectCollection>>(
+                    config,
+                    /* maxDeltaR = */ config.getParameter<double>("maxDeltaR"),
+                    /* maxMatches = */ size_t(0),
+                    /* allowIdenticalIndices = */ true,
+                    /* useEtaPhiGrid = */ config.getParameter<bool>("useEtaPhiGrid")) {};
         virtual ~JetTriggerObjectMatchingProducer() {};
 
         // -- pSet descriptions for CMSSW help info
@@ -76,7 +81,12 @@ namespace karma {
                 karma::JetCollection,
                 karma::MuonCollection,
                 JetMuonMatcher,
-                edm::OneToMany<karma::JetCollection, karma::MuonCollection>>(config, config.getParameter<double>("maxDeltaR")) {};
+                edm::OneToMany<karma::JetCollection, karma::MuonCollection>>(
+                    config,
+                    /* maxDeltaR = */ config.getParameter<double>("maxDeltaR"),
+                    /* maxMatches = */ size_t(0),
+                    /* allowIdenticalIndices = */ true,
+                    /* useEtaPhiGrid = */ config.getParameter<bool>("useEtaPhiGrid")) {};
         virtual ~JetMuonMatchingProducer() {};
 
         // -- pSet descriptions for CMSSW help info
@@ -97,7 +107,12 @@ namespace karma {
                 karma::JetCollection,
                 karma::ElectronCollection,
                 JetElectronMatcher,
-                edm::OneToMany<karma::JetCollection, karma::ElectronCollection>>(config, config.getParameter<double>("maxDeltaR")) {};
+                edm::OneToMany<karma::JetCollection, karma::ElectronCollection>>(
+                    config,
+                    /* maxDeltaR = */ config.getParameter<double>("maxDeltaR"),
+                    /* maxMatches = */ size_t(0),
+                    /* allowIdenticalIndices = */ true,
+                    /* useEtaPhiGrid = */ config.getParameter<bool>("useEtaPhiGrid")) {};
         virtual ~JetElectronMatchingProducer() {};
 
         // -- pSet descriptions for CMSSW help info
@@ -118,7 +133,12 @@ namespace karma {
                 karma::JetCollection,
                 karma::LVCollection,
                 JetLVMatcher,
-                edm::OneToOne<karma::JetCollection, karma::LVCollection>>(config, config.getParameter<double>("maxDeltaR")) {};
+                edm::OneToOne<karma::JetCollection, karma::LVCollection>>(
+                    config,
+                    /* maxDeltaR = */ config.getParameter<double>("maxDeltaR"),
+                    /* maxMatches = */ size_t(0),
+                    /* allowIdenticalIndices = */ true,
+                    /* useEtaPhiGrid = */ config.getParameter<bool>("useEtaPhiGrid")) {};
         virtual ~JetLVMatchingProducer() {};
 
         // -- pSet descriptions for CMSSW help info
@@ -0,0 +1,209 @@
+#pragma once
+
+// system include files
+#include <memory>
+#include <string>
+#include <vector>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/stream/EDProducer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+
+#include "Karma/Common/interface/EDMTools/Util.h"
+#include "Karma/Common/interface/Tools/Matchers.h"
+
+// -- input/output data formats
+#include "DataFormats/Common/interface/Ref.h"
+#include "DataFormats/Common/interface/AssociationMap.h"
+#include "Karma/SkimmingFormats/interface/Event.h"
+#include "Karma/SkimmingFormats/interface/IndexAssociation.h"
+
+//
+// class declaration
+//
+namespace karma {
+
+    // -- matching of the jets to one secondary collection
+
+    /**
+     * Interface for matching the jets to one of the secondary collections
+     * configured in `JetMultiMatchingProducer`.
+     */
+    class JetSecondaryMatchingTask {
+
+      public:
+        virtual ~JetSecondaryMatchingTask() {};
+
+        /** Match the secondary collection to the jets and put the association into the event */
+        virtual void produce(edm::Event& event, const edm::Handle<karma::JetCollection>& jetCollectionHandle, const karma::EtaPhiCache& jetEtaPhiCache) = 0;
+    };
+
+    /**
+     * Matches the jets to a secondary collection of type `TSecondaryCollection`
+     * and puts the resulting `TProduct` into the event under the product instance
+     * label `name`. If `produceIndexAssociation` is set, a `karma::IndexAssociation`
+     * is put into the event under the same label (see `GenericMatchingProducer`).
+     */
+    template<typename TSecondaryCollection,
+             typename Matcher,
+             typename TProduct>
+    class JetSecondaryMatchingTaskImpl : public JetSecondaryMatchingTask {
+
+      public:
+        typedef TSecondaryCollection SecondaryCollection;
+        typedef TProduct Product;
+
+        JetSecondaryMatchingTaskImpl(const edm::EDGetTokenT<TSecondaryCollection>& token, const std::string& name, double maxDeltaR, bool produceIndexAssociation) :
+            m_name(name),
+            m_produceIndexAssociation(produceIndexAssociation),
+            m_matcher(new Matcher(maxDeltaR)),
+            secondaryCollectionToken(token) {};
+        virtual ~JetSecondaryMatchingTaskImpl() {};
+
+        virtual void produce(edm::Event& event, const edm::Handle<karma::JetCollection>& jetCollectionHandle, const karma::EtaPhiCache& jetEtaPhiCache) {
+
+            karma::util::getByTokenOrThrow(event, this->secondaryCollectionToken, this->secondaryCollectionHandle);
+
+            // create new TProduct (note: needs to provide constructor from RefProds)
+            std::unique_ptr<TProduct> product(new TProduct(
+                edm::RefProd<karma::JetCollection>(jetCollectionHandle),
+                edm::RefProd<TSecondaryCollection>(this->secondaryCollectionHandle)
+            ));
+
+            // match using the jet kinematics shared between all tasks (result buffer is reused between events)
+            m_matcher->match(jetEtaPhiCache, *this->secondaryCollectionHandle, m_matchResults);
+
+            // commit the match results to the product
+            for (const auto& matchedIndexPair : m_matchResults) {
+                product->insert(
+                    edm::Ref<karma::JetCollection>(jetCollectionHandle, matchedIndexPair.first),
+                    edm::Ref<TSecondaryCollection>(this->secondaryCollectionHandle, matchedIndexPair.second)
+                );
+            }
+
+            // move outputs to event tree
+            event.put(std::move(product), m_name);
+
+            // -- optionally store the match results as a compact index-based association
+            if (m_produceIndexAssociation) {
+                m_matchMetricValues.clear();
+                for (const auto& matchedIndexPair : m_matchResults) {
+                    m_matchMetricValues.push_back(m_matcher->metricValue(
+                        (*jetCollectionHandle)[matchedIndexPair.first],
+                        (*this->secondaryCollectionHandle)[matchedIndexPair.second]
+                    ));
+                }
+
+                std::unique_ptr<karma::IndexAssociation> indexAssociation(new karma::IndexAssociation());
+                indexAssociation->fill(
+                    jetCollectionHandle.id(), this->secondaryCollectionHandle.id(),
+                    jetCollectionHandle->size(), m_matchResults, m_matchMetricValues
+                );
+                event.put(std::move(indexAssociation), m_name);
+            }
+        };
+
+      private:
+        const std::string m_name;
+        const bool m_produceIndexAssociation;
+
+        std::unique_ptr<Matcher> m_matcher;
+        std::vector<std::pair<int, int>> m_matchResults;
+        std::vector<double> m_matchMetricValues;
+
+        // -- handles and tokens
+
+        typename edm::Handle<TSecondaryCollection> secondaryCollectionHandle;
+        edm::EDGetTokenT<TSecondaryCollection> secondaryCollectionToken;
+    };
+
+    // -- producer
+
+    /**
+     * Producer which matches one jet collection to several secondary collections
+     * in a single pass. The jet kinematics are computed only once per event and
+     * shared between all matchers.
+     *
+     * Each entry of the `secondaryCollections` VPSet configures one secondary
+     * collection (`type`, `src` and `maxDeltaR`). The resulting association is
+     * stored under the product instance label `name`.
+     *
+     * The optional `metric` parameter selects the matching strategy:
+     * `deltaRThreshold` (all secondaries within `maxDeltaR`) or `lowestDeltaR`
+     * (injective, closest pairs first). By default, the strategy of the
+     * corresponding producer in `JetMatchingProducers.h` is used, so that the
+     * associations are identical. The one-to-one `LV` association only supports
+     * `lowestDeltaR`.
+     *
+     * If `produceIndexAssociation` is set, a `karma::IndexAssociation` is
+     * produced for each secondary collection in addition, under the same label.
+     */
+    class JetMultiMatchingProducer : public edm::stream::EDProducer<> {
+
+      public:
+        explicit JetMultiMatchingProducer(const edm::ParameterSet&);
+        virtual ~JetMultiMatchingProducer() {};
+
+        // -- pSet descriptions for CMSSW help info
+        static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+        // -- "regular" per-Event 'produce' method
+        virtual void produce(edm::Event&, const edm::EventSetup&);
+
+      private:
+
+        /** Register products and consumed collection and create the matching task using the configured metric */
+        template<typename TSecondaryCollection, typename TProduct>
+        void addMatchingTask(const edm::ParameterSet& secondaryCollectionPSet, const std::string& metric) {
+            const auto& name = secondaryCollectionPSet.getParameter<std::string>("name");
+            const auto token = consumes<TSecondaryCollection>(secondaryCollectionPSet.getParameter<edm::InputTag>("src"));
+            const double maxDeltaR = secondaryCollectionPSet.getParameter<double>("maxDeltaR");
+
+            produces<TProduct>(name);
+            if (m_produceIndexAssociation) {
+                produces<karma::IndexAssociation>(name);
+            }
+
+            if (metric == "deltaRThreshold") {
+                m_matchingTasks.emplace_back(new JetSecondaryMatchingTaskImpl<
+                    TSecondaryCollection,
+                    karma::StaticCachedDeltaRThresholdMatcher<karma::JetCollection, TSecondaryCollection>,
+                    TProduct>(token, name, maxDeltaR, m_produceIndexAssociation));
+            }
+            else if (metric == "lowestDeltaR") {
+                m_matchingTasks.emplace_back(new JetSecondaryMatchingTaskImpl<
+                    TSecondaryCollection,
+                    karma::StaticCachedLowestDeltaRMatcher<karma::JetCollection, TSecondaryCollection>,
+                    TProduct>(token, name, maxDeltaR, m_produceIndexAssociation));
+            }
+            else {
+                throw edm::Exception(
+                    edm::errors::ConfigFileReadError,
+                    "[JetMultiMatchingProducer] Invalid value '" + metric + "' for 'metric' parameter "
+                    "of secondary collection '" + name + "'. Expected one of: 'deltaRThreshold', 'lowestDeltaR'."
+                );
+            }
+        };
+
+        // ----------member data ---------------------------
+
+        const edm::ParameterSet& m_configPSet;
+
+        bool m_produceIndexAssociation;
+
+        std::vector<std::unique_ptr<JetSecondaryMatchingTask>> m_matchingTasks;
+        karma::EtaPhiCache m_jetEtaPhiCache;
+
+        // -- handles and tokens
+
+        edm::Handle<karma::JetCollection> jetCollectionHandle;
+        edm::EDGetTokenT<karma::JetCollection> jetCollectionToken;
+
+    };
+}  // end namespace
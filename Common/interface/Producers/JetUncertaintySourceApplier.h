@@ -72,6 +72,8 @@ namespace karma {
 
         // names of the uncertainty source shifts to apply
         std::vector<std::string> m_jetUncertaintySourceNames;
+        std::vector<karma::TransientKey> m_jetUncertaintySourceKeys;
+        const karma::TransientKey m_transientKeyTotal{"Total"};
 
         // -- handles and tokens
         typename edm::Handle<karma::JetCollection> karmaJetCollectionHandle;
@@ -75,6 +75,10 @@ namespace karma {
         bool m_stochasticOnly = true;
         double m_jerGenMatchPtSigma = 3.0;
 
+        // keys for the transient maps (resolved once)
+        const karma::TransientKey m_transientKeyJERScaleFactor{"JERScaleFactor"};
+        const karma::TransientKey m_transientKeyJERSmearingFactor{"JERSmearingFactor"};
+
         // -- handles and tokens
         typename edm::Handle<karma::Event> karmaEventHandle;
         edm::EDGetTokenT<karma::Event> karmaEventToken;
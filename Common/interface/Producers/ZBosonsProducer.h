@@ -56,8 +56,8 @@ namespace karma {
             produces<karma::LVCollection>("positiveLeptons");
             produces<karma::LVCollection>("negativeLeptons");
 
-            m_matcher = std::unique_ptr<LowestAbsDeltaInvariantMassMatcher<TLeptonCollection>>(
-                new LowestAbsDeltaInvariantMassMatcher<TLeptonCollection>(
+            m_matcher = std::unique_ptr<StaticLowestAbsDeltaInvariantMassMatcher<TLeptonCollection>>(
+                new StaticLowestAbsDeltaInvariantMassMatcher<TLeptonCollection>(
                  /* targetInvariantMass = */ Z_BOSON_MASS_GEV,
                  /* maxDeltaInvariantMass = */ globalCache->maxDeltaInvariantMass_,
                  /* maxMatches = */ 1,
@@ -114,8 +114,8 @@ namespace karma {
             );
 
             // apply matcher between opposite-charge collections
-            const auto& matchingIndexPairs = this->m_matcher->match(
-                positiveLeptons, negativeLeptons
+            this->m_matcher->match(
+                positiveLeptons, negativeLeptons, m_matchingIndexPairs
             );
 
             /// if (matchingIndexPairs.size() != 0) {
@@ -125,7 +125,7 @@ namespace karma {
             ///     zBosonLV->p4 = positiveLeptonLV->p4 + negativeLeptonLV->p4;
             /// }
 
-            for (const auto& matchingIndexPair : matchingIndexPairs) {
+            for (const auto& matchingIndexPair : m_matchingIndexPairs) {
               positiveLeptonLVs->emplace_back();
               positiveLeptonLVs->back().p4 = positiveLeptons.at(matchingIndexPair.first).p4;
 
@@ -148,7 +148,8 @@ namespace karma {
 
         const edm::ParameterSet& m_configPSet;
 
-        std::unique_ptr<LowestAbsDeltaInvariantMassMatcher<TLeptonCollection>> m_matcher;
+        std::unique_ptr<StaticLowestAbsDeltaInvariantMassMatcher<TLeptonCollection>> m_matcher;
+        std::vector<std::pair<int, int>> m_matchingIndexPairs;
 
         static constexpr const double Z_BOSON_MASS_GEV = 91.1876;
 
@@ -1,12 +1,18 @@
 #pragma once
 
 #include <algorithm>
+#include <map>
+#include <memory>
 #include <vector>
 #include <numeric>
 #include <exception>
+#include <limits>
+#include <stdexcept>
 
 #include "yaml-cpp/yaml.h"
 
+#include "Karma/Common/interface/Providers/FlexGridTables.h"
+
 #include <boost/algorithm/string.hpp>  // for boost::split
 #include <boost/algorithm/string/join.hpp>
 
@@ -94,14 +100,57 @@ class FlexGrid {
      * varying binning structure. Establishes contiguous indexing
      * of bins and provides methods to retrieve the global bin index
      * from a tuple of (unbinned) values.
+     *
+     * A FlexGrid is not modified by any of its `const` methods, so
+     * once it is fully set up it can be shared between threads (e.g.
+     * as a `std::shared_ptr<const FlexGrid>` in a module's GlobalCache)
+     * and all lookups can be called concurrently.
      */
   public:
     explicit FlexGrid(const std::string& yamlFile) : _rootFlexNode(yamlFile) {
-        _indexBins(_rootFlexNode, 0);
+        _nGlobalBins = _indexBins(_rootFlexNode, 0);
+        _flatTables = _compileFlatTables();
     };
 
   private:
 
+    /**
+     * Compile the node tree into flat lookup tables (bin structure only). Bin
+     * edges of all nodes are stored contiguously and the child nodes of each
+     * node are stored contiguously (breadth-first order).
+     */
+    karma::FlexGridTables _compileFlatTables(const std::vector<karma::FlexGridTables::Column>& columns = {}) const {
+        std::vector<karma::FlexGridTables::Node> flatNodes;
+        std::vector<double> flatBinEdges;
+
+        // breadth-first traversal, so that the children of each node are adjacent
+        std::vector<const FlexNode*> nodeQueue = {&_rootFlexNode};
+        for (size_t iNode = 0; iNode < nodeQueue.size(); ++iNode) {
+            const FlexNode& node = *nodeQueue[iNode];
+            const auto& bins = node.getBins();
+
+            karma::FlexGridTables::Node flatNode;
+            flatNode.binEdgesOffset = flatBinEdges.size();
+            flatNode.nBinEdges = bins.size();
+            flatBinEdges.insert(flatBinEdges.end(), bins.begin(), bins.end());
+
+            if (node.hasSubstructure()) {
+                flatNode.childNodesOffset = nodeQueue.size();
+                flatNode.globalBinIndexOffset = -1;
+                for (size_t iBin = 0; iBin < bins.size() - 1; ++iBin) {
+                    nodeQueue.push_back(&node.getSubnode(iBin));
+                }
+            }
+            else {
+                flatNode.childNodesOffset = -1;
+                flatNode.globalBinIndexOffset = (bins.size() > 1) ? node.getGlobalBinIndex(0) : -1;
+            }
+            flatNodes.push_back(flatNode);
+        }
+
+        return karma::FlexGridTables(flatNodes, flatBinEdges, _nGlobalBins, columns);
+    }
+
     static int _indexBins(FlexNode& node, int idxOffset=0) {
         if (node.hasSubstructure()) {
             auto& substructure = node.getSubstructure();
@@ -178,9 +227,10 @@ class FlexGrid {
                     throw std::runtime_error("Number of values exceeds number of defined binning levels");
                 }
                 // iteratively retrieve metadata nodes according to 'keySequence'
-                YAML::Node binMetadataNode = subkeyLookup(node.getMetadata(), keySequence.begin(), keySequence.end());
+                // (lookup does not modify the metadata, so this is safe to call concurrently)
+                YAML::Node binMetadataNode = FlexGrid::_findSubkey(node.getMetadata(), keySequence.begin(), keySequence.end());
                 // check if node exists
-                if (binMetadataNode.IsNull()) {
+                if (!binMetadataNode.IsDefined() || binMetadataNode.IsNull()) {
                     throw std::runtime_error("Failed to retrieve bin metadata: key '" + boost::algorithm::join(keySequence, ".") + "' not found");
                 }
                 // check if final value is a sequence
@@ -198,9 +248,121 @@ class FlexGrid {
         }
     }
 
+    /**
+     * Same as `subkeyLookup`, but never modifies `node` and returns an undefined
+     * node instead of throwing if a key is not present.
+     */
+    template <typename TIterator>
+    static YAML::Node _findSubkey(const YAML::Node& node, TIterator keySequenceIterStart, TIterator keySequenceIterEnd) {
+        if (keySequenceIterStart == keySequenceIterEnd) {
+            return node;
+        }
+        if (!node.IsDefined() || !node.IsMap()) {
+            return YAML::Node(YAML::NodeType::Undefined);
+        }
+        return _findSubkey(node[*keySequenceIterStart], std::next(keySequenceIterStart), keySequenceIterEnd);
+    }
+
+    /** Write metadata values for key 'keySequence' for all bins under `node` to `column` */
+    template <typename T>
+    static void _fillMetadataColumn(const FlexNode& node, const std::vector<std::string>& keySequence, std::vector<T>& column) {
+        const size_t nBins = node.getBins().size() - 1;
+        if (node.hasSubstructure()) {
+            for (size_t iBin = 0; iBin < nBins; ++iBin) {
+                FlexGrid::_fillMetadataColumn(node.getSubnode(iBin), keySequence, column);
+            }
+            return;
+        }
+
+        // metadata must be a sequence with one entry per bin (otherwise leave all bins as missing)
+        const YAML::Node binMetadataNode = FlexGrid::_findSubkey(node.getMetadata(), keySequence.begin(), keySequence.end());
+        if (!binMetadataNode.IsDefined() || !binMetadataNode.IsSequence() || (binMetadataNode.size() != nBins)) {
+            return;
+        }
+        for (size_t iBin = 0; iBin < nBins; ++iBin) {
+            try {
+                column[node.getGlobalBinIndex(iBin)] = binMetadataNode[iBin].as<T>();
+            }
+            catch (const YAML::Exception& err) {
+                // value cannot be converted to `T` -> leave as missing
+            }
+        }
+    }
+
   public:
+    /** Number of bins (global bin indices run from 1 to this number) */
+    int numBins() const { return _nGlobalBins; }
+
+    /**
+     * Resolve the metadata key 'keySpec' (subkeys separated by '.') for all bins
+     * and return the values as a dense column indexed by global bin index. Entry 0
+     * (not a valid bin index) and bins without a value convertible to `T` are set
+     * to `missingValue`.
+     */
+    template <typename T>
+    std::vector<T> makeMetadataColumn(const std::string& keySpec, const T& missingValue) const {
+        // split string `keySpec` on delimiter '.'
+        std::vector<std::string> keySequence;
+        boost::split(keySequence, keySpec, [](char c){return c == '.';});
+
+        std::vector<T> column(_nGlobalBins + 1, missingValue);
+        FlexGrid::_fillMetadataColumn(_rootFlexNode, keySequence, column);
+        return column;
+    }
+
+    /** Flat lookup tables for the bin structure (without metadata columns) */
+    const karma::FlexGridTables& getFlatTables() const { return _flatTables; }
+
+    /**
+     * Compile the bin structure together with the metadata columns for the keys in
+     * `intKeySpecs` and `doubleKeySpecs` into flat tables, e.g. for writing them to
+     * a binary file. Missing values are set to `intMissingValue` and `doubleMissingValue`.
+     */
+    karma::FlexGridTables compileTables(const std::vector<std::string>& intKeySpecs, const std::vector<std::string>& doubleKeySpecs,
+                                        int intMissingValue = -1, double doubleMissingValue = std::numeric_limits<double>::quiet_NaN()) const {
+        std::vector<karma::FlexGridTables::Column> columns;
+        for (const auto& keySpec : intKeySpecs) {
+            columns.push_back({keySpec, makeMetadataColumn<int>(keySpec, intMissingValue), {}, karma::FlexGridTables::INT32});
+        }
+        for (const auto& keySpec : doubleKeySpecs) {
+            columns.push_back({keySpec, {}, makeMetadataColumn<double>(keySpec, doubleMissingValue), karma::FlexGridTables::FLOAT64});
+        }
+        return _compileFlatTables(columns);
+    }
+
+    /**
+     * Find global index of bin which corresponds to the sequence of `nValues` values
+     * starting at `values` (one value per binning level). Returns -1 if the values
+     * are outside the binning range. Uses the flat lookup tables and does not allocate.
+     */
+    int findIndex(const double* values, size_t nValues) const {
+        return _flatTables.findIndex(values, nValues);
+    }
+
+    /** Same as above, for a fixed number of values (e.g. a braced list `{value1, value2}`) */
+    template<size_t N>
+    int findIndex(const double (&values)[N]) const {
+        return findIndex(values, N);
+    }
+
+    /**
+     * Find global bin indices for `n` entries at once, reading the values of binning
+     * level `iLevel` from `columns[iLevel]` (see `karma::FlexGridTables::findIndices`)
+     */
+    void findIndices(const double* const* columns, size_t nLevels, size_t n, int* out, karma::FlexGridTables::SearchHint* hint = nullptr) const {
+        _flatTables.findIndices(columns, nLevels, n, out, hint);
+    }
+
     /** Find global index of bin which corresponds to sequence of `values` */
     int findIndex(const std::vector<double>& values) const {
+        return findIndex(values.data(), values.size());
+    }
+
+    /**
+     * Same as `findIndex`, but walking the tree of `FlexNode`s recursively
+     * (reference implementation, e.g. for cross-checks and benchmarks)
+     */
+    int findIndexInTree(const std::vector<double>& values) const {
         return FlexGrid::_findIndex(_rootFlexNode, values.begin(), values.end());
     }
 
@@ -214,27 +376,100 @@ class FlexGrid {
     }
 
     FlexNode _rootFlexNode;
+
+  private:
+    int _nGlobalBins;
+
+    // flat lookup tables compiled from the node tree (bin structure only, no metadata)
+    karma::FlexGridTables _flatTables;
 };
 
 
 namespace karma {
+
+    /**
+     * Handle to a metadata column of type `T` registered with a `FlexGridBinProvider`.
+     * Only valid for the provider which created it.
+     */
+    template <typename T>
+    class FlexGridMetadataHandle {
+        friend class FlexGridBinProvider;
+      public:
+        FlexGridMetadataHandle() : _columnIndex(-1) {};
+        bool isValid() const { return _columnIndex >= 0; };
+      private:
+        explicit FlexGridMetadataHandle(int columnIndex) : _columnIndex(columnIndex) {};
+        int _columnIndex;
+    };
+
+    /**
+     * Provides bin indices and bin metadata from a `FlexGrid`.
+     *
+     * The FlexGrid itself is immutable and can be shared between several
+     * providers (e.g. one per stream), which only hold the lookup caches.
+     *
+     * Alternatively, the provider can be created from precompiled
+     * `FlexGridTables` (e.g. memory-mapped from a binary file). In this
+     * case, only the bin lookup and the typed metadata columns contained
+     * in the tables are available (no YAML metadata).
+     */
     class FlexGridBinProvider {
       public:
 
-        explicit FlexGridBinProvider(const FlexGrid& flexGrid) : _flexGrid(std::unique_ptr<FlexGrid>(new FlexGrid(flexGrid))) {};
+        /** Use a shared FlexGrid (not copied) */
+        explicit FlexGridBinProvider(std::shared_ptr<const FlexGrid> flexGrid) :
+            _flexGrid(std::move(flexGrid)),
+            _flatTables(_flexGrid, &_flexGrid->getFlatTables()) {};
+        /** Use a private copy of a FlexGrid */
+        explicit FlexGridBinProvider(const FlexGrid& flexGrid) : FlexGridBinProvider(std::make_shared<const FlexGrid>(flexGrid)) {};
         explicit FlexGridBinProvider(const std::string& yamlFile) :
-            _flexGrid(new FlexGrid(yamlFile)) {};
+            FlexGridBinProvider(std::make_shared<const FlexGrid>(yamlFile)) {};
+        /** Use shared precompiled tables (no YAML metadata available) */
+        explicit FlexGridBinProvider(std::shared_ptr<const FlexGridTables> flatTables) : _flatTables(std::move(flatTables)) {};
         ~FlexGridBinProvider() {};
 
-        FlexGrid& getFlexGrid() { return *_flexGrid; };
+        /** True if the provider has a `FlexGrid` (i.e. was not created from precompiled tables) */
+        bool hasFlexGrid() const { return static_cast<bool>(_flexGrid); };
+
+        const FlexGrid& getFlexGrid() const {
+            if (!_flexGrid) {
+                throw std::logic_error("[FlexGridBinProvider] No FlexGrid available: provider was created from precompiled tables!");
+            }
+            return *_flexGrid;
+        };
+
+        const FlexGridTables& getFlatTables() const { return *_flatTables; };
+
+        int getFlexGridBin(const std::vector<double>& values) const {
+            return _flatTables->findIndex(values.data(), values.size());
+        };
+
+        /** Same as above, for `nValues` values starting at `values` (does not allocate) */
+        int getFlexGridBin(const double* values, size_t nValues) const {
+            return _flatTables->findIndex(values, nValues);
+        };
 
-        int getFlexGridBin(const std::vector<double>& values) {
-            return _flexGrid->findIndex(values);
+        /**
+         * Same as above, for a fixed number of values. Braced lists such as
+         * `getFlexGridBin({value1, value2})` bind to this overload and do not allocate.
+         */
+        template<size_t N>
+        int getFlexGridBin(const double (&values)[N]) const {
+            return _flatTables->findIndex(values, N);
+        };
+
+        /**
+         * Bin indices for `n` entries at once (e.g. all jets in an event), reading the
+         * values of binning level `iLevel` from `columns[iLevel]`. Search hints are kept
+         * in the provider between calls, so this method is not `const`.
+         */
+        void getFlexGridBins(const double* const* columns, size_t nLevels, size_t n, int* out) {
+            _flatTables->findIndices(columns, nLevels, n, out, &_searchHint);
         };
 
         YAML::Node getFlexGridBinMetadata(const std::string& keySpec, const std::vector<double>& values) {
             // retrieve global bin index for metadata lookup in cache
-            const int globalBinIndex = _flexGrid->findIndex(values);
+            const int globalBinIndex = getFlexGrid().findIndex(values);
             // throw if values outside binning range
             if (globalBinIndex < 0) {
                 throw std::out_of_range("Failed to retrieve bin metadata: bin values out of bounds!");
@@ -246,15 +481,77 @@ namespace karma {
             return cachedMetadataNode;
         };
 
+        /**
+         * Resolve the metadata key 'keySpec' for all bins into a typed column
+         * (supported types: `int`, `double`) and return a handle for accessing it.
+         * Bins without a value for the key yield `missingValue`. Should be called
+         * before the event loop, e.g. in the module constructor.
+         *
+         * If the provider was created from precompiled tables, the column is taken
+         * from the tables (throws if not available), and bins without a value yield
+         * the missing value used when compiling the tables.
+         */
+        template <typename T>
+        FlexGridMetadataHandle<T> registerMetadataColumn(const std::string& keySpec, const T& missingValue) {
+            auto& columns = _getMetadataColumns<T>();
+            if (_flexGrid) {
+                columns.push_back(_flexGrid->makeMetadataColumn<T>(keySpec, missingValue));
+            }
+            else {
+                const auto* tablesColumn = _getTablesColumn<T>(keySpec);
+                if (!tablesColumn) {
+                    throw std::out_of_range("[FlexGridBinProvider] Metadata column '" + keySpec + "' not available in precompiled tables!");
+                }
+                columns.emplace_back(tablesColumn, tablesColumn + _flatTables->numBins() + 1);
+            }
+            return FlexGridMetadataHandle<T>(columns.size() - 1);
+        };
+
+        /**
+         * Metadata value for the bin with global index `globalBinIndex`. Returns the
+         * missing value for invalid bin indices (e.g. -1 for values outside the
+         * binning range) and bins without metadata. Does not throw or parse YAML.
+         */
+        template <typename T>
+        const T& getFlexGridBinMetadata(const FlexGridMetadataHandle<T>& handle, int globalBinIndex) const {
+            const auto& column = _getMetadataColumns<T>()[handle._columnIndex];
+            // entry 0 holds the missing value
+            return column[(globalBinIndex > 0 && static_cast<size_t>(globalBinIndex) < column.size()) ? globalBinIndex : 0];
+        };
+
+        /** Same as above, looking up the bin which corresponds to the sequence of `values` */
+        template <typename T, size_t N>
+        const T& getFlexGridBinMetadata(const FlexGridMetadataHandle<T>& handle, const double (&values)[N]) const {
+            return getFlexGridBinMetadata(handle, _flatTables->findIndex(values, N));
+        };
+
       private:
 
+        template <typename T> std::vector<std::vector<T>>& _getMetadataColumns();
+        template <typename T> const std::vector<std::vector<T>>& _getMetadataColumns() const;
+        template <typename T> const T* _getTablesColumn(const std::string& keySpec) const;
+
         YAML::Node _getFlexGridBinMetadata(const std::string& keySpec, const std::vector<double>& values) {
-            return _flexGrid->findBinMetadata(keySpec, values);
+            return getFlexGrid().findBinMetadata(keySpec, values);
         };
 
-        std::unique_ptr<FlexGrid> _flexGrid;
+        std::shared_ptr<const FlexGrid> _flexGrid;  // null if created from precompiled tables
+        std::shared_ptr<const FlexGridTables> _flatTables;  // for bin lookup (may alias `_flexGrid`)
+        // search hints for batch lookups (per provider, i.e. not shared between streams)
+        FlexGridTables::SearchHint _searchHint;
         // cache metadata by global index to increase lookup efficiency
         std::map<std::string,std::map<int, YAML::Node>> _cacheMapKeySpecBinIndexToMetadataNode;
 
+        // typed metadata columns, indexed by global bin index
+        std::vector<std::vector<int>> _intMetadataColumns;
+        std::vector<std::vector<double>> _doubleMetadataColumns;
+
     };
+
+    template <> inline std::vector<std::vector<int>>& FlexGridBinProvider::_getMetadataColumns<int>() { return _intMetadataColumns; }
+    template <> inline std::vector<std::vector<double>>& FlexGridBinProvider::_getMetadataColumns<double>() { return _doubleMetadataColumns; }
+    template <> inline const std::vector<std::vector<int>>& FlexGridBinProvider::_getMetadataColumns<int>() const { return _intMetadataColumns; }
+    template <> inline const std::vector<std::vector<double>>& FlexGridBinProvider::_getMetadataColumns<double>() const { return _doubleMetadataColumns; }
+    template <> inline const int* FlexGridBinProvider::_getTablesColumn<int>(const std::string& keySpec) const { return _flatTables->getIntColumn(keySpec); }
+    template <> inline const double* FlexGridBinProvider::_getTablesColumn<double>(const std::string& keySpec) const { return _flatTables->getDoubleColumn(keySpec); }
 }
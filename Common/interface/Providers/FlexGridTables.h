@@ -0,0 +1,492 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// for memory-mapping binary files
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace karma {
+
+    /**
+     * Compiled (flat) form of a `FlexGrid`: the bin structure and, optionally,
+     * typed metadata columns indexed by global bin index.
+     *
+     * All data is kept in one contiguous, position-independent buffer which is
+     * identical to the binary file format. Tables can therefore be written to a
+     * file as-is and loaded again by memory-mapping the file read-only, in which
+     * case all processes on a node using the same file share the pages.
+     *
+     * Binary layout (native byte order, all sections 8-byte aligned):
+     *   - `Header`
+     *   - `Node[nNodes]`: bin structure, children of a node are adjacent
+     *   - `double[nBinEdges]`: bin edges of all nodes
+     *   - `ColumnInfo[nColumns]`: name, type and data offset of metadata columns
+     *   - column data: `nGlobalBins + 1` values of type `int32_t` or `double` per column
+     *     (entry 0 is not a valid global bin index and holds the missing value)
+     *
+     * Tables are immutable, and all methods can be called concurrently.
+     */
+    class FlexGridTables {
+
+        // -- helpers for the column-based `findIndices` (declared first for use in its signature)
+
+        /** Element type of a container providing `data()` and `size()` (no `type` otherwise) */
+        template <typename TColumn, typename = void>
+        struct _ColumnValueType {};
+
+        template <typename TColumn>
+        struct _ColumnValueType<TColumn, decltype(void(std::declval<const TColumn&>().data()), void(std::declval<const TColumn&>().size()))> {
+            typedef typename std::remove_cv<typename std::remove_pointer<decltype(std::declval<const TColumn&>().data())>::type>::type type;
+        };
+
+        template <bool...> struct _BoolPack;
+
+        /** True if all types are arithmetic (also true for an empty pack) */
+        template <typename... Ts>
+        struct _AreAllArithmetic : std::is_same<_BoolPack<true, std::is_arithmetic<Ts>::value...>, _BoolPack<std::is_arithmetic<Ts>::value..., true>> {};
+
+      public:
+        // -- binary format
+
+        static constexpr uint32_t FORMAT_VERSION = 1;
+        static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+        enum ColumnType : uint32_t {
+            INT32 = 0,
+            FLOAT64 = 1,
+        };
+
+        struct Header {
+            char magic[8];             // "KFLXGRID"
+            uint32_t formatVersion;    // `FORMAT_VERSION`
+            uint32_t byteOrderMark;    // `BYTE_ORDER_MARK` in the byte order of the writer
+            uint64_t nBytes;           // total size in bytes
+            uint32_t nNodes;
+            uint32_t nBinEdges;
+            uint32_t nGlobalBins;
+            uint32_t nColumns;
+        };
+
+        struct Node {
+            uint32_t binEdgesOffset;       // index of first bin edge
+            uint32_t nBinEdges;            // number of bin edges
+            int32_t childNodesOffset;      // index of first child node (-1 if no substructure)
+            int32_t globalBinIndexOffset;  // global index of first bin (nodes without substructure only)
+        };
+
+        struct ColumnInfo {
+            char name[112];       // metadata key spec (null-terminated)
+            uint32_t type;        // `ColumnType`
+            uint32_t reserved;
+            uint64_t dataOffset;  // offset of the column data in bytes
+        };
+
+        /** Metadata column to be stored in the tables */
+        struct Column {
+            std::string name;
+            std::vector<int> intValues;        // for type `INT32`
+            std::vector<double> doubleValues;  // for type `FLOAT64`
+            ColumnType type;
+        };
+
+        // -- construction
+
+        FlexGridTables() {};
+
+        /** Build tables from the flat bin structure and metadata columns (`nGlobalBins + 1` values each) */
+        FlexGridTables(const std::vector<Node>& nodes, const std::vector<double>& binEdges, int nGlobalBins, const std::vector<Column>& columns = {}) {
+
+            // -- compute section offsets
+            const uint64_t nodesOffset = _alignedSize(sizeof(Header));
+            const uint64_t binEdgesOffset = nodesOffset + _alignedSize(nodes.size() * sizeof(Node));
+            const uint64_t columnInfosOffset = binEdgesOffset + _alignedSize(binEdges.size() * sizeof(double));
+            uint64_t nBytes = columnInfosOffset + _alignedSize(columns.size() * sizeof(ColumnInfo));
+
+            std::vector<ColumnInfo> columnInfos(columns.size());
+            for (size_t iColumn = 0; iColumn < columns.size(); ++iColumn) {
+                const auto& column = columns[iColumn];
+                const size_t nValues = (column.type == INT32) ? column.intValues.size() : column.doubleValues.size();
+                if (nValues != static_cast<size_t>(nGlobalBins) + 1) {
+                    throw std::runtime_error("Failed to build FlexGrid tables: size of metadata column '" + column.name + "' does not match number of bins!");
+                }
+                if (column.name.size() >= sizeof(ColumnInfo::name)) {
+                    throw std::runtime_error("Failed to build FlexGrid tables: metadata column name '" + column.name + "' too long!");
+                }
+                auto& columnInfo = columnInfos[iColumn];
+                std::memset(&columnInfo, 0, sizeof(ColumnInfo));
+                std::strncpy(columnInfo.name, column.name.c_str(), sizeof(ColumnInfo::name) - 1);
+                columnInfo.type = column.type;
+                columnInfo.dataOffset = nBytes;
+                nBytes += _alignedSize(nValues * ((column.type == INT32) ? sizeof(int32_t) : sizeof(double)));
+            }
+
+            // -- fill buffer (use uint64_t storage for 8-byte alignment)
+            auto buffer = std::make_shared<std::vector<uint64_t>>(nBytes / sizeof(uint64_t), 0);
+            char* data = reinterpret_cast<char*>(buffer->data());
+
+            Header header;
+            std::memset(&header, 0, sizeof(Header));
+            std::memcpy(header.magic, _magic(), sizeof(header.magic));
+            header.formatVersion = FORMAT_VERSION;
+            header.byteOrderMark = BYTE_ORDER_MARK;
+            header.nBytes = nBytes;
+            header.nNodes = nodes.size();
+            header.nBinEdges = binEdges.size();
+            header.nGlobalBins = nGlobalBins;
+            header.nColumns = columns.size();
+            std::memcpy(data, &header, sizeof(Header));
+
+            std::copy(nodes.begin(), nodes.end(), reinterpret_cast<Node*>(data + nodesOffset));
+            std::copy(binEdges.begin(), binEdges.end(), reinterpret_cast<double*>(data + binEdgesOffset));
+            std::copy(columnInfos.begin(), columnInfos.end(), reinterpret_cast<ColumnInfo*>(data + columnInfosOffset));
+            for (size_t iColumn = 0; iColumn < columns.size(); ++iColumn) {
+                const auto& column = columns[iColumn];
+                char* columnData = data + columnInfos[iColumn].dataOffset;
+                if (column.type == INT32) {
+                    std::copy(column.intValues.begin(), column.intValues.end(), reinterpret_cast<int32_t*>(columnData));
+                }
+                else {
+                    std::copy(column.doubleValues.begin(), column.doubleValues.end(), reinterpret_cast<double*>(columnData));
+                }
+            }
+
+            _setData(std::shared_ptr<const void>(buffer, buffer->data()), data, nBytes);
+        };
+
+        /** Load tables by memory-mapping a binary file (read-only) */
+        static FlexGridTables mapFile(const std::string& fileName) {
+            const int fileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+            if (fileDescriptor < 0) {
+                throw std::ios_base::failure("[FlexGridTables] Could not open file '" + fileName + "'!");
+            }
+            struct stat fileStat;
+            if ((::fstat(fileDescriptor, &fileStat) != 0) || (fileStat.st_size < static_cast<off_t>(sizeof(Header)))) {
+                ::close(fileDescriptor);
+                throw std::runtime_error("[FlexGridTables] File '" + fileName + "' is not a valid FlexGrid binary file!");
+            }
+            const size_t nBytes = fileStat.st_size;
+            void* mapped = ::mmap(nullptr, nBytes, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+            ::close(fileDescriptor);  // mapping stays valid
+            if (mapped == MAP_FAILED) {
+                throw std::ios_base::failure("[FlexGridTables] Could not memory-map file '" + fileName + "'!");
+            }
+
+            // unmap when the last copy of the tables is destroyed
+            std::shared_ptr<const void> storage(mapped, [nBytes](void* address) { ::munmap(address, nBytes); });
+
+            FlexGridTables tables;
+            tables._setData(storage, static_cast<const char*>(mapped), nBytes);
+            return tables;
+        };
+
+        /** Write tables to a binary file (can be loaded with `mapFile`) */
+        void writeFile(const std::string& fileName) const {
+            std::ofstream outFile(fileName, std::ios::binary | std::ios::trunc);
+            if (!outFile) {
+                throw std::ios_base::failure("[FlexGridTables] Could not open file '" + fileName + "' for writing!");
+            }
+            outFile.write(_data, _nBytes);
+            if (!outFile) {
+                throw std::ios_base::failure("[FlexGridTables] Failed to write file '" + fileName + "'!");
+            }
+        };
+
+        // -- lookup
+
+        bool isValid() const { return _data != nullptr; };
+
+        /** Number of bins (global bin indices run from 1 to this number) */
+        int numBins() const { return _header->nGlobalBins; };
+
+        /**
+         * Find global index of bin which corresponds to the sequence of `nValues`
+         * values starting at `values` (one value per binning level). Returns -1 if
+         * the values are outside the binning range. Does not allocate.
+         */
+        int findIndex(const double* values, size_t nValues) const {
+            if (nValues == 0) {
+                throw std::runtime_error("Insufficient number of values");
+            }
+            const Node* node = &_nodes[0];
+            for (size_t iValue = 0; ; ++iValue) {
+                const double* binEdges = &_binEdges[node->binEdgesOffset];
+                const size_t nextPosition = FlexGridTables::_countBinEdgesNotAbove(binEdges, node->nBinEdges, values[iValue]);
+                if ((nextPosition == 0) || (nextPosition == node->nBinEdges)) {
+                    return -1;
+                }
+                const int nextIdx = nextPosition - 1;
+
+                if (node->childNodesOffset >= 0) {
+                    if (iValue + 1 == nValues) {
+                        throw std::runtime_error("Insufficient number of values");
+                    }
+                    node = &_nodes[node->childNodesOffset + nextIdx];
+                }
+                else {
+                    if (iValue + 1 != nValues) {
+                        throw std::runtime_error("Number of values exceeds number of defined binning levels");
+                    }
+                    return node->globalBinIndexOffset + nextIdx;
+                }
+            }
+        };
+
+        /** Same as above, for a fixed number of values (e.g. a braced list `{value1, value2}`) */
+        template <size_t N>
+        int findIndex(const double (&values)[N]) const {
+            return findIndex(values, N);
+        };
+
+        /**
+         * Search hints for `findIndices`: the node and bin found last at each
+         * binning level. Consecutive values falling into the same bin (e.g. for
+         * sorted inputs) are then binned without a full search.
+         * Can be kept between calls, but must not be shared between threads.
+         */
+        struct SearchHint {
+            std::vector<int> nodeIndices;
+            std::vector<int> binIndices;
+        };
+
+        /**
+         * Find global bin indices for `n` entries at once. The values for binning level
+         * `iLevel` are read from the column `columns[iLevel]` (of length `n`), and the
+         * index for entry `i` is written to `out[i]` (-1 if outside the binning range).
+         * Gives the same results as `findIndex`.
+         *
+         * If `hint` is given, the bin found last at each level is tried first, and the
+         * hints are stored in `hint` so they carry over to subsequent calls. This pays
+         * off for sorted inputs (e.g. jets ordered by pT), but costs time for unordered
+         * ones, for which `hint` should be omitted.
+         */
+        void findIndices(const double* const* columns, size_t nLevels, size_t n, int* out, SearchHint* hint = nullptr) const {
+            if (nLevels == 0) {
+                throw std::runtime_error("Insufficient number of values");
+            }
+            if (hint) {
+                hint->nodeIndices.resize(nLevels, -1);
+                hint->binIndices.resize(nLevels, -1);
+                _findIndices<true>(columns, nLevels, n, out, hint->nodeIndices.data(), hint->binIndices.data());
+            }
+            else {
+                _findIndices<false>(columns, nLevels, n, out, nullptr, nullptr);
+            }
+        };
+
+        /**
+         * Same as above, for containers providing `data()` and `size()` (e.g. `std::vector<float>`
+         * or `ROOT::VecOps::RVec<float>`), with one container per binning level. Intended for
+         * binning per-object columns in a single call, e.g. in an RDataFrame `Define`:
+         *
+         *     df.Define("Jet_binIndex", "flexGridTables.findIndices(Jet_absEta, Jet_pt)")
+         *
+         * Any arithmetic element type is accepted. Columns which do not hold `double`s
+         * are converted to a temporary `double` buffer before the lookup.
+         */
+        template <typename... TColumns>
+        auto findIndices(const TColumns&... columns) const
+                -> typename std::enable_if<_AreAllArithmetic<typename _ColumnValueType<TColumns>::type...>::value, std::vector<int>>::type {
+            static_assert(sizeof...(TColumns) > 0, "FlexGridTables::findIndices: at least one column (one per binning level) is required");
+
+            std::vector<double> convertedColumns[sizeof...(TColumns)];
+            size_t iColumn = 0;
+            const double* columnData[] = {_columnDataAsDoubles(columns, convertedColumns[iColumn++])...};
+            const size_t columnSizes[] = {static_cast<size_t>(columns.size())...};
+            for (const size_t columnSize : columnSizes) {
+                if (columnSize != columnSizes[0]) {
+                    throw std::runtime_error("Failed to find bin indices: columns have different sizes!");
+                }
+            }
+            std::vector<int> indices(columnSizes[0]);
+            SearchHint hint;
+            findIndices(columnData, sizeof...(TColumns), indices.size(), indices.data(), &hint);
+            return indices;
+        };
+
+        /** Metadata column with name 'name' and type `int` (`nullptr` if not available) */
+        const int32_t* getIntColumn(const std::string& name) const {
+            return static_cast<const int32_t*>(_findColumn(name, INT32));
+        };
+
+        /** Metadata column with name 'name' and type `double` (`nullptr` if not available) */
+        const double* getDoubleColumn(const std::string& name) const {
+            return static_cast<const double*>(_findColumn(name, FLOAT64));
+        };
+
+        size_t numColumns() const { return _header->nColumns; };
+        std::string getColumnName(size_t iColumn) const { return _columnInfos[iColumn].name; };
+        ColumnType getColumnType(size_t iColumn) const { return static_cast<ColumnType>(_columnInfos[iColumn].type); };
+
+      private:
+
+        static const char* _magic() { return "KFLXGRID"; };
+
+        /** Pointer to the column values as `double`s: `double` columns are used directly, others are copied to `buffer` */
+        template <typename TColumn>
+        static const double* _columnDataAsDoubles(const TColumn& column, std::vector<double>& buffer) {
+            return _columnDataAsDoubles(column, buffer, std::is_same<typename _ColumnValueType<TColumn>::type, double>());
+        };
+
+        template <typename TColumn>
+        static const double* _columnDataAsDoubles(const TColumn& column, std::vector<double>&, std::true_type) {
+            return column.data();
+        };
+
+        template <typename TColumn>
+        static const double* _columnDataAsDoubles(const TColumn& column, std::vector<double>& buffer, std::false_type) {
+            buffer.assign(column.data(), column.data() + column.size());
+            return buffer.data();
+        };
+
+        static uint64_t _alignedSize(uint64_t nBytes) { return (nBytes + 7) & ~uint64_t(7); };
+
+        /**
+         * Number of bin edges less than or equal to `value` (same as the position
+         * returned by `std::upper_bound`). Branchless binary search: the loop
+         * always runs ceil(log2(nBinEdges)) times and the comparison result is
+         * only used to compute the next address.
+         */
+        static size_t _countBinEdgesNotAbove(const double* binEdges, size_t nBinEdges, double value) {
+            if (nBinEdges == 0) {
+                return 0;
+            }
+            const double* base = binEdges;
+            size_t length = nBinEdges;
+            while (length > 1) {
+                const size_t half = length / 2;
+                base = (base[half] <= value) ? base + half : base;
+                length -= half;
+            }
+            // note: 'nan' values compare false and yield zero (i.e. out of bounds)
+            return (base - binEdges) + (*base <= value);
+        };
+
+        /** Implementation of `findIndices` (hint arrays hold one entry per level if `useHint`) */
+        template <bool useHint>
+        void _findIndices(const double* const* columns, size_t nLevels, size_t n, int* out, int* hintNodeIndices, int* hintBinIndices) const {
+            for (size_t iEntry = 0; iEntry < n; ++iEntry) {
+                int nodeIndex = 0;
+                for (size_t iLevel = 0; ; ++iLevel) {
+                    const Node& node = _nodes[nodeIndex];
+                    const double* binEdges = &_binEdges[node.binEdgesOffset];
+                    const double value = columns[iLevel][iEntry];
+
+                    int nextIdx;
+                    if (useHint && (hintNodeIndices[iLevel] == nodeIndex) && (binEdges[hintBinIndices[iLevel]] <= value) && (value < binEdges[hintBinIndices[iLevel] + 1])) {
+                        nextIdx = hintBinIndices[iLevel];
+                    }
+                    else {
+                        const size_t nextPosition = FlexGridTables::_countBinEdgesNotAbove(binEdges, node.nBinEdges, value);
+                        if ((nextPosition == 0) || (nextPosition == node.nBinEdges)) {
+                            out[iEntry] = -1;
+                            break;
+                        }
+                        nextIdx = nextPosition - 1;
+                        if (useHint) {
+                            hintNodeIndices[iLevel] = nodeIndex;
+                            hintBinIndices[iLevel] = nextIdx;
+                        }
+                    }
+
+                    if (node.childNodesOffset >= 0) {
+                        if (iLevel + 1 == nLevels) {
+                            throw std::runtime_error("Insufficient number of values");
+                        }
+                        nodeIndex = node.childNodesOffset + nextIdx;
+                    }
+                    else {
+                        if (iLevel + 1 != nLevels) {
+                            throw std::runtime_error("Number of values exceeds number of defined binning levels");
+                        }
+                        out[iEntry] = node.globalBinIndexOffset + nextIdx;
+                        break;
+                    }
+                }
+            }
+        };
+
+        /** Set section pointers after validating the buffer (throws if invalid) */
+        void _setData(std::shared_ptr<const void> storage, const char* data, size_t nBytes) {
+            auto fail = [](const std::string& reason) {
+                throw std::runtime_error("[FlexGridTables] Invalid FlexGrid binary data: " + reason);
+            };
+
+            // -- header
+            if (nBytes < sizeof(Header)) fail("too small");
+            const Header* header = reinterpret_cast<const Header*>(data);
+            if (std::memcmp(header->magic, _magic(), sizeof(header->magic)) != 0) fail("wrong magic number");
+            if (header->byteOrderMark != BYTE_ORDER_MARK) fail("wrong byte order");
+            if (header->formatVersion != FORMAT_VERSION) fail("unsupported format version " + std::to_string(header->formatVersion));
+            if (header->nBytes != nBytes) fail("size does not match header");
+            if (header->nNodes == 0) fail("no nodes");
+
+            // -- sections
+            const uint64_t nodesOffset = _alignedSize(sizeof(Header));
+            const uint64_t binEdgesOffset = nodesOffset + _alignedSize(uint64_t(header->nNodes) * sizeof(Node));
+            const uint64_t columnInfosOffset = binEdgesOffset + _alignedSize(uint64_t(header->nBinEdges) * sizeof(double));
+            if (columnInfosOffset + uint64_t(header->nColumns) * sizeof(ColumnInfo) > nBytes) fail("sections exceed size");
+
+            const Node* nodes = reinterpret_cast<const Node*>(data + nodesOffset);
+            for (size_t iNode = 0; iNode < header->nNodes; ++iNode) {
+                const Node& node = nodes[iNode];
+                const uint64_t nBins = (node.nBinEdges > 0) ? node.nBinEdges - 1 : 0;
+                if (uint64_t(node.binEdgesOffset) + node.nBinEdges > header->nBinEdges) fail("bin edges out of range");
+                if ((node.childNodesOffset >= 0) && (uint64_t(node.childNodesOffset) + nBins > header->nNodes)) fail("child nodes out of range");
+                if ((node.childNodesOffset < 0) && (nBins > 0) && ((node.globalBinIndexOffset < 1) || (uint64_t(node.globalBinIndexOffset) + nBins - 1 > header->nGlobalBins))) fail("global bin indices out of range");
+            }
+
+            const ColumnInfo* columnInfos = reinterpret_cast<const ColumnInfo*>(data + columnInfosOffset);
+            for (size_t iColumn = 0; iColumn < header->nColumns; ++iColumn) {
+                const ColumnInfo& columnInfo = columnInfos[iColumn];
+                if (columnInfo.name[sizeof(ColumnInfo::name) - 1] != '\0') fail("column name not terminated");
+                if ((columnInfo.type != INT32) && (columnInfo.type != FLOAT64)) fail("unknown column type");
+                const uint64_t valueSize = (columnInfo.type == INT32) ? sizeof(int32_t) : sizeof(double);
+                if ((columnInfo.dataOffset % 8 != 0) || (columnInfo.dataOffset + (uint64_t(header->nGlobalBins) + 1) * valueSize > nBytes)) fail("column data out of range");
+            }
+
+            _storage = std::move(storage);
+            _data = data;
+            _nBytes = nBytes;
+            _header = header;
+            _nodes = nodes;
+            _binEdges = reinterpret_cast<const double*>(data + binEdgesOffset);
+            _columnInfos = columnInfos;
+        };
+
+        const void* _findColumn(const std::string& name, ColumnType type) const {
+            for (size_t iColumn = 0; iColumn < _header->nColumns; ++iColumn) {
+                if ((_columnInfos[iColumn].type == type) && (name == _columnInfos[iColumn].name)) {
+                    return _data + _columnInfos[iColumn].dataOffset;
+                }
+            }
+            return nullptr;
+        };
+
+        // owns the data (buffer in memory or mapped file), shared between copies
+        std::shared_ptr<const void> _storage;
+
+        const char* _data = nullptr;
+        size_t _nBytes = 0;
+
+        // pointers to the sections of `_data`
+        const Header* _header = nullptr;
+        const Node* _nodes = nullptr;
+        const double* _binEdges = nullptr;
+        const ColumnInfo* _columnInfos = nullptr;
+    };
+
+}  // end namespace
@@ -0,0 +1,53 @@
+#pragma once
+
+// system include files
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+
+namespace karma {
+    namespace benchmark {
+
+        /**
+         * Call `function` repeatedly until at least `minDurationSeconds` have
+         * passed and return the mean wall-clock time per call in nanoseconds.
+         * The function is called once beforehand to warm up caches.
+         */
+        template<typename Function>
+        double timePerCall(Function&& function, double minDurationSeconds = 0.2) {
+            typedef std::chrono::steady_clock Clock;
+
+            function();  // warm-up
+
+            size_t nCalls = 0;
+            const auto start = Clock::now();
+            std::chrono::duration<double> elapsed(0);
+            do {
+                function();
+                ++nCalls;
+                elapsed = Clock::now() - start;
+            } while (elapsed.count() < minDurationSeconds);
+
+            return 1e9 * elapsed.count() / nCalls;
+        }
+
+        /**
+         * Print one line of a benchmark report: the time per call and the
+         * time per processed item (e.g. per primary-secondary pair).
+         */
+        inline void printResult(const std::string& name, double nsPerCall, double itemsPerCall, const std::string& itemName) {
+            // format into a local stream to leave the state of `std::cout` untouched
+            std::ostringstream line;
+            line << "  " << std::left << std::setw(48) << name << std::right
+                 << std::fixed << std::setprecision(1)
+                 << std::setw(14) << nsPerCall << " ns/call"
+                 << std::setprecision(3)
+                 << std::setw(12) << (itemsPerCall > 0 ? nsPerCall / itemsPerCall : 0.0) << " ns/" << itemName;
+            std::cout << line.str() << std::endl;
+        }
+
+    }  // end namespace
+}  // end namespace
@@ -2,6 +2,11 @@
 
 // system include files
 #include <memory>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
 
 #include "Math/VectorUtil.h"
 
@@ -11,28 +16,345 @@
 namespace karma {
 
     /**
-     * GenericMatcher
-     *   - abstract class (only for specifying interface)
+     * EtaPhiGrid
+     *   - spatial index which buckets the elements of a collection in a uniform eta-phi grid
+     *   - cells are (at least) `cellSize` wide in both eta and phi, and wrap around in phi
+     *   - any element within a DeltaR of `cellSize` of a query point is guaranteed to lie in one
+     *     of the 3x3 cells around it, so only these need to be searched
+     *   - cells are enlarged so that there are at most `MAX_CELLS_PER_ELEMENT` cells per bucketed
+     *     element, which keeps the cost of filling the grid proportional to the collection size
+     *     even for very small `cellSize`
+     *   - elements with non-finite eta or phi are not bucketed and are returned for every query
      */
-    template<typename TPrimaryCollection,
-             typename TSecondaryCollection>
-    class GenericMatcher {
+    class EtaPhiGrid {
+
       public:
-        GenericMatcher(size_t maxMatches = 0, bool allowIdenticalIndices = true) :
-            maxMatches_(maxMatches),
-            allowIdenticalIndices_(allowIdenticalIndices) {};
-        virtual ~GenericMatcher() {};
+        explicit EtaPhiGrid(double cellSize) {
+            // pad the cell size slightly to be robust against rounding at the cell boundaries
+            cellSize_ = cellSize * (1.0 + 1e-9);
+        };
 
-        virtual std::vector<std::pair<int, int>> match(
-            const TPrimaryCollection& primaryCollection, const TSecondaryCollection& secondaryCollection) = 0;
+        /** False if the grid cannot be used for the configured cell size */
+        bool isValid() const { return std::isfinite(cellSize_) && (cellSize_ > 0); }
+
+        /**
+         * Bucket the elements of `collection` (replaces any previous content), to be queried
+         * for `nQueries` points. Returns false if the grid is not expected to be faster than
+         * evaluating all pairs, i.e. if there are few pairs or if the grid has so few cells that
+         * the 3x3 cells around a point contain a large fraction of the elements. In that case,
+         * the grid is left empty and must not be queried.
+         */
+        template<typename TCollection>
+        bool fill(const TCollection& collection, size_t nQueries) {
+            unbinnedIndices_.clear();
+            cellIndices_.clear();
+            cellOffsets_.clear();
+            nEtaCells_ = 0;
+
+            if (!isValid() || (nQueries * collection.size() < MIN_PAIRS)) {
+                return false;
+            }
+
+            // determine eta range of the collection
+            double etaMin = std::numeric_limits<double>::infinity();
+            double etaMax = -std::numeric_limits<double>::infinity();
+            size_t nBinned = 0;
+            for (const auto& element : collection) {
+                if (std::isfinite(element.p4.eta()) && std::isfinite(element.p4.phi())) {
+                    etaMin = std::min(etaMin, clampEta(element.p4.eta()));
+                    etaMax = std::max(etaMax, clampEta(element.p4.eta()));
+                    ++nBinned;
+                }
+            }
+            if (nBinned == 0) {
+                return false;
+            }
+
+            // -- choose cell sizes: at least `cellSize_`, enlarged to limit the number of cells
+            int nPhiCells = static_cast<int>(std::min(std::floor(2 * M_PI / cellSize_), double(MAX_CELLS_PER_AXIS)));
+            if (nPhiCells < 1) nPhiCells = 1;
+            double etaCellSize = std::max(cellSize_, (etaMax - etaMin) / (MAX_CELLS_PER_AXIS - 1));
+            const double nEtaCellsUnlimited = std::floor((etaMax - etaMin) / etaCellSize) + 1;
+            const double maxCells = double(MAX_CELLS_PER_ELEMENT * nBinned);
+            if (nPhiCells * nEtaCellsUnlimited > maxCells) {
+                // enlarge the cells along both axes by the same factor (as far as possible)
+                const double enlargementFactor = std::sqrt(nPhiCells * nEtaCellsUnlimited / maxCells);
+                const double nEtaCellsTarget = std::max(nEtaCellsUnlimited / enlargementFactor, 1.0);
+                nPhiCells = std::max(std::min(static_cast<int>(maxCells / nEtaCellsTarget), nPhiCells), 1);
+
+                // eta cells large enough for the remaining number of cells
+                const int maxEtaCells = std::max(static_cast<int>(maxCells / nPhiCells), 1);
+                etaCellSize = std::max(etaCellSize, (etaMax - etaMin) / (maxEtaCells - 0.5));
+            }
+            nPhiCells_ = nPhiCells;
+            phiCellSize_ = 2 * M_PI / nPhiCells_;
+            etaMin_ = etaMin;
+            etaCellSize_ = etaCellSize;
+            nEtaCells_ = static_cast<int>(std::floor((etaMax - etaMin) / etaCellSize_)) + 1;
+
+            // not worth it if the 3x3 cells around a point cover a large part of the grid
+            if (nEtaCells_ * nPhiCells_ < MIN_CELLS) {
+                nEtaCells_ = 0;
+                return false;
+            }
+
+            // -- counting sort of element indices by cell (keeps index order within each cell)
+
+            // count elements per cell, then turn counts into the end offset of each cell
+            cellOffsets_.assign(nEtaCells_ * nPhiCells_ + 1, 0);
+            elementCells_.resize(collection.size());
+            for (size_t iElement = 0; iElement < collection.size(); ++iElement) {
+                const auto& p4 = collection[iElement].p4;
+                if (!std::isfinite(p4.eta()) || !std::isfinite(p4.phi())) {
+                    unbinnedIndices_.push_back(iElement);
+                    elementCells_[iElement] = -1;
+                    continue;
+                }
+                elementCells_[iElement] = etaCell(p4.eta()) * nPhiCells_ + phiCell(p4.phi());
+                ++cellOffsets_[elementCells_[iElement]];
+            }
+            for (size_t iCell = 1; iCell < cellOffsets_.size(); ++iCell) {
+                cellOffsets_[iCell] += cellOffsets_[iCell - 1];
+            }
+
+            // place elements back to front, leaving each offset at the start of its cell
+            cellIndices_.resize(nBinned);
+            for (size_t iElement = collection.size(); iElement-- > 0; ) {
+                if (elementCells_[iElement] >= 0) {
+                    cellIndices_[--cellOffsets_[elementCells_[iElement]]] = iElement;
+                }
+            }
+            return true;
+        };
 
-      protected:
-          const size_t maxMatches_;
-          const bool allowIdenticalIndices_;
+        /**
+         * Write the indices of all elements in the 3x3 cells around `p4` to `candidates`,
+         * in ascending order. If `p4` itself cannot be binned, all indices are returned.
+         */
+        void getCandidates(const karma::LorentzVector& p4, std::vector<size_t>& candidates) const {
+            candidates.clear();
+            if (!std::isfinite(p4.eta()) || !std::isfinite(p4.phi())) {
+                candidates.insert(candidates.end(), cellIndices_.begin(), cellIndices_.end());
+            }
+            else if (nEtaCells_ > 0) {
+                // eta cell relative to the grid (may be outside the grid by one cell)
+                const double etaInCells = std::floor((clampEta(p4.eta()) - etaMin_) / etaCellSize_);
+                const int iEta = static_cast<int>(std::max(-2.0, std::min(etaInCells, double(nEtaCells_ + 1))));
+                const int iPhi = phiCell(p4.phi());
+
+                // neighboring phi cells (avoid visiting a cell twice for coarse grids)
+                const int phiCells[3] = {(iPhi + nPhiCells_ - 1) % nPhiCells_, iPhi, (iPhi + 1) % nPhiCells_};
+                const int nNeighborPhiCells = std::min(nPhiCells_, 3);
+
+                for (int iEtaNeighbor = std::max(iEta - 1, 0); iEtaNeighbor <= std::min(iEta + 1, nEtaCells_ - 1); ++iEtaNeighbor) {
+                    for (int iNeighbor = 0; iNeighbor < nNeighborPhiCells; ++iNeighbor) {
+                        const int iCell = iEtaNeighbor * nPhiCells_ + phiCells[iNeighbor];
+                        candidates.insert(candidates.end(), cellIndices_.begin() + cellOffsets_[iCell], cellIndices_.begin() + cellOffsets_[iCell + 1]);
+                    }
+                }
+            }
+            candidates.insert(candidates.end(), unbinnedIndices_.begin(), unbinnedIndices_.end());
+            std::sort(candidates.begin(), candidates.end());
+        };
+
+        /** Number of cells of the grid (zero if not filled) */
+        int numCells() const { return nEtaCells_ * nPhiCells_; }
+
+      private:
+
+        // maximum number of cells along each axis (cells are enlarged beyond that)
+        static constexpr int MAX_CELLS_PER_AXIS = 1024;
+        // maximum number of cells per bucketed element (cells are enlarged beyond that)
+        static constexpr size_t MAX_CELLS_PER_ELEMENT = 2;
+        // minimum number of pairs and of cells for which the grid is used
+        static constexpr size_t MIN_PAIRS = 1024;
+        static constexpr int MIN_CELLS = 36;
+        // eta values are clamped to this range (preserves neighborhood relations)
+        static constexpr double MAX_ABS_ETA = 100.0;
+
+        static double clampEta(double eta) {
+            return std::max(-MAX_ABS_ETA, std::min(MAX_ABS_ETA, eta));
+        };
+
+        int etaCell(double eta) const {
+            const int iEta = static_cast<int>(std::floor((clampEta(eta) - etaMin_) / etaCellSize_));
+            return std::min(std::max(iEta, 0), nEtaCells_ - 1);
+        };
+
+        int phiCell(double phi) const {
+            // map phi to [0, 2*pi) before binning
+            double phiShifted = std::fmod(phi + M_PI, 2 * M_PI);
+            if (phiShifted < 0) phiShifted += 2 * M_PI;
+            const int iPhi = static_cast<int>(phiShifted / phiCellSize_);
+            return std::min(std::max(iPhi, 0), nPhiCells_ - 1);
+        };
+
+        double cellSize_;
+
+        // binning is adapted to the bucketed collection
+        double phiCellSize_ = 2 * M_PI;
+        int nPhiCells_ = 1;
+        double etaMin_ = 0;
+        double etaCellSize_ = 0;
+        int nEtaCells_ = 0;
+
+        // element indices sorted by cell, with offsets of each cell (CSR layout)
+        std::vector<size_t> cellIndices_;
+        std::vector<size_t> cellOffsets_;
+        std::vector<size_t> unbinnedIndices_;
+
+        // work buffer for filling
+        std::vector<int> elementCells_;
+    };
+
+    /**
+     * GreedyPairAssignment
+     *   - helper for injective matching: collects candidate pairs with their metric values and
+     *     accepts them from _best_ (lowest metric value) to _worst_, skipping pairs which involve
+     *     an already matched primary or secondary object
+     *   - ties are resolved by lowest secondary index, then lowest primary index
+     *   - buffers are kept between calls to avoid reallocation
+     */
+    class GreedyPairAssignment {
+
+      public:
+        void clear() { metricTriples_.clear(); }
+
+        void addCandidate(double metricValue, size_t primaryIndex, size_t secondaryIndex) {
+            metricTriples_.push_back({metricValue, primaryIndex, secondaryIndex});
+        };
+
+        /** Append accepted pairs to `matchResult` (at most `maxMatches`, if nonzero) */
+        void assign(size_t nPrimary, size_t nSecondary, size_t maxMatches, std::vector<std::pair<int, int>>& matchResult) {
+
+            // -- sort pairs from best to worst match
+            std::sort(metricTriples_.begin(), metricTriples_.end());
+
+            // -- accept the best pair not involving already-matched objects
+            usedPrimaryIndices_.assign(nPrimary, false);
+            usedSecondaryIndices_.assign(nSecondary, false);
+            size_t nMatches = 0;
+            for (const auto& metricTriple : metricTriples_) {
+
+                // disallow further matches involving already matched indices
+                if (usedPrimaryIndices_[metricTriple.primaryIndex] || usedSecondaryIndices_[metricTriple.secondaryIndex])
+                    continue;
+
+                matchResult.emplace_back(metricTriple.primaryIndex, metricTriple.secondaryIndex);
+                ++nMatches;
+
+                // return early if we reached the maximum number of allowed matched
+                if ((maxMatches > 0) && (nMatches >= maxMatches))
+                    return;
+
+                // stop if all primary or all secondary elements have been matched
+                if (nMatches >= std::min(nPrimary, nSecondary))
+                    return;
+
+                usedPrimaryIndices_[metricTriple.primaryIndex] = true;
+                usedSecondaryIndices_[metricTriple.secondaryIndex] = true;
+            }
+        };
+
+      private:
+        /** Candidate pair with its metric value (ordered by value, then secondary and primary index) */
+        struct MetricTriple {
+            double metricValue;
+            size_t primaryIndex;
+            size_t secondaryIndex;
+
+            bool operator<(const MetricTriple& other) const {
+                if (metricValue != other.metricValue) return metricValue < other.metricValue;
+                if (secondaryIndex != other.secondaryIndex) return secondaryIndex < other.secondaryIndex;
+                return primaryIndex < other.primaryIndex;
+            }
+        };
+
+        std::vector<MetricTriple> metricTriples_;
+        std::vector<bool> usedPrimaryIndices_;
+        std::vector<bool> usedSecondaryIndices_;
+    };
+
+    // -- cached (structure-of-arrays) kinematics
+
+    /**
+     * EtaPhiCache
+     *   - copies eta and phi of all elements of a collection into contiguous arrays,
+     *     so that pairwise quantities can be computed in vectorizable loops
+     */
+    class EtaPhiCache {
+      public:
+        template<typename TCollection>
+        void fill(const TCollection& collection) {
+            eta_.resize(collection.size());
+            phi_.resize(collection.size());
+            for (size_t iElement = 0; iElement < collection.size(); ++iElement) {
+                eta_[iElement] = collection[iElement].p4.eta();
+                phi_[iElement] = collection[iElement].p4.phi();
+            }
+        };
+
+        size_t size() const { return eta_.size(); }
+        const double* eta() const { return eta_.data(); }
+        const double* phi() const { return phi_.data(); }
+
+      private:
+        std::vector<double> eta_;
+        std::vector<double> phi_;
+    };
+
+    /**
+     * Compute the squared DeltaR between a reference point (`eta`, `phi`) and `n` points given
+     * by the arrays `etas` and `phis`, writing the results to `deltaR2`.
+     *
+     * The loop is free of branches (phi is wrapped to (-pi, pi] by arithmetic on the comparison
+     * results) so that it can be auto-vectorized. The operations are the same as in
+     * ROOT::Math::VectorUtil::DeltaR2, so the results are bit-identical to the square of
+     * `DeltaRFunctor`.
+     */
+    inline void computeDeltaR2(double eta, double phi, const double* etas, const double* phis, size_t n, double* deltaR2) {
+        for (size_t i = 0; i < n; ++i) {
+            double dPhi = phi - phis[i];
+            dPhi -= (2.0 * M_PI) * ((dPhi > M_PI) - (dPhi <= -M_PI));
+            const double dEta = eta - etas[i];
+            deltaR2[i] = dPhi * dPhi + dEta * dEta;
+        }
+    }
+
+
+    // -- metric functors
+
+    /**
+     * Functor operates on LVs and returns DeltaR
+     */
+    struct DeltaRFunctor {
+        double operator()(const karma::LorentzVector& v1, const karma::LorentzVector& v2) const {
+            return ROOT::Math::VectorUtil::DeltaR(v1, v2);
+        }
+    };
+
+    /**
+     * Functor operates on LVs and returns the absolute value of the difference
+     * between the invariant mass of the LVs and a reference invariant mass
+     * value. The reference mass is a parameter of the functor.
+     */
+    struct AbsDeltaInvariantMassFunctor {
+        AbsDeltaInvariantMassFunctor(double targetInvariantMass) : targetInvariantMass_(targetInvariantMass) {};
+        double targetInvariantMass_;
+        double operator()(const karma::LorentzVector& v1, const karma::LorentzVector& v2) const {
+            return std::abs(targetInvariantMass_ - ROOT::Math::VectorUtil::InvariantMass(v1, v2));
+        }
     };
 
+    // -- static matchers
+    //
+    // These implement the matching algorithms without virtual dispatch. The method
+    // `match(primaryCollection, secondaryCollection, matchResult)` clears `matchResult`
+    // and writes the matched index pairs to it, so the caller can reuse the same buffer
+    // for every event. The metric functor is a template parameter and is inlined.
+
     /**
-     * LowestMetricMatcher
+     * StaticLowestMetricMatcher
      *   - finds matches among all possible pairs of objects in primary and secondary collections
      *   - pairs are matched depending on the metric function, from _best_ to _worst_
      *   - a match is _better_ the _lower_ the metric function
@@ -40,47 +362,64 @@ namespace karma {
      *   - matching is injective (a secondary object is matched to at most one primary object)
      */
     template<typename TPrimaryCollection, typename TSecondaryCollection, typename MetricFunctor>
-    class LowestMetricMatcher : public GenericMatcher<TPrimaryCollection, TSecondaryCollection> {
+    class StaticLowestMetricMatcher {
 
       public:
-        LowestMetricMatcher(double maxMetricValue, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
-            GenericMatcher<TPrimaryCollection, TSecondaryCollection>(maxMatches, allowIdenticalIndices),
+        StaticLowestMetricMatcher(double maxMetricValue, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            maxMatches_(maxMatches),
+            allowIdenticalIndices_(allowIdenticalIndices),
             maxMetricValue_(maxMetricValue),
             metricFunctor_(MetricFunctor()) {};
 
-        LowestMetricMatcher(const MetricFunctor metricFunctor, double maxMetricValue, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
-            GenericMatcher<TPrimaryCollection, TSecondaryCollection>(maxMatches, allowIdenticalIndices),
+        StaticLowestMetricMatcher(const MetricFunctor metricFunctor, double maxMetricValue, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            maxMatches_(maxMatches),
+            allowIdenticalIndices_(allowIdenticalIndices),
             maxMetricValue_(maxMetricValue),
             metricFunctor_(metricFunctor) {};
 
-        virtual std::vector<std::pair<int, int>> match(
-                const TPrimaryCollection& primaryCollection, const TSecondaryCollection& secondaryCollection) {
+        /** Use an eta-phi grid to only consider nearby pairs (DeltaR metric only) */
+        void enableEtaPhiGrid() {
+            static_assert(std::is_same<MetricFunctor, DeltaRFunctor>::value, "Eta-phi grid requires DeltaR metric!");
+            etaPhiGrid_.reset(new EtaPhiGrid(maxMetricValue_));
+        };
 
-            std::vector<std::pair<int, int>> matchResult;
+        void match(const TPrimaryCollection& primaryCollection, const TSecondaryCollection& secondaryCollection,
+                   std::vector<std::pair<int, int>>& matchResult) {
+
+            matchResult.clear();
 
             // do matching only if collections are not empty
             if ((primaryCollection.size() != 0) && (secondaryCollection.size() != 0)) {
 
-                // -- compute delta-R for all primary-secondary pairs
-                double metricMatrix[primaryCollection.size()][secondaryCollection.size()];
+                // -- compute the metric for all primary-secondary pairs and keep those within range
+                greedyPairAssignment_.clear();
+
+                // if available and worthwhile, use the eta-phi grid to only consider nearby secondaries
+                // (pairs not considered are beyond the max. metric value)
+                const bool useGrid = (etaPhiGrid_ && etaPhiGrid_->fill(secondaryCollection, primaryCollection.size()));
+
                 for (size_t iPrimary = 0; iPrimary < primaryCollection.size(); ++iPrimary) {
-                    const auto& primaryElement = primaryCollection.at(iPrimary);
+                    const auto& primaryElement = primaryCollection[iPrimary];
+
+                    if (useGrid) {
+                        etaPhiGrid_->getCandidates(primaryElement.p4, candidateIndices_);
+                    }
+                    const size_t nCandidates = useGrid ? candidateIndices_.size() : secondaryCollection.size();
+
+                    for (size_t iCandidate = 0; iCandidate < nCandidates; ++iCandidate) {
+                        const size_t iSecondary = useGrid ? candidateIndices_[iCandidate] : iCandidate;
 
-                    for (size_t iSecondary = 0; iSecondary < secondaryCollection.size(); ++iSecondary) {
                         // make this pairing impossible if indices are the same and matching them is not allowed
-                        if ((!this->allowIdenticalIndices_) && (iPrimary == iSecondary)) {
-                            metricMatrix[iPrimary][iSecondary] = std::numeric_limits<double>::quiet_NaN();
+                        if ((!allowIdenticalIndices_) && (iPrimary == iSecondary)) {
                             continue;
                         }
 
-                        const auto& secondaryElement = secondaryCollection.at(iSecondary);
+                        const auto& secondaryElement = secondaryCollection[iSecondary];
 
+                        // note: 'nan' metric values fail the comparison and are vetoed
                         const double metricValue = metricFunctor_(secondaryElement.p4, primaryElement.p4);
                         if (metricValue <= maxMetricValue_) {
-                            metricMatrix[iPrimary][iSecondary] = metricValue;
-                        }
-                        else {
-                            metricMatrix[iPrimary][iSecondary] = std::numeric_limits<double>::quiet_NaN();
+                            greedyPairAssignment_.addCandidate(metricValue, iPrimary, iSecondary);
                         }
 
                     } // end for (secondaryElements)
@@ -88,63 +427,34 @@ namespace karma {
                 } // end for (primaryElements)
 
                 // -- do actual matching
-                for (size_t iIteration = 0; iIteration < primaryCollection.size(); ++iIteration) {
-
-                    // identify pair of indices with best match (lowest overall metric value)
-                    int bestMatchPrimaryIndex = -1;
-                    int bestMatchSecondaryIndex = -1;
-                    double bestMatchMetricValue = std::numeric_limits<double>::quiet_NaN();
-                    for (size_t iSecondary = 0; iSecondary < secondaryCollection.size(); ++iSecondary) {
-                        for (size_t iRecoJet = 0; iRecoJet < primaryCollection.size(); ++iRecoJet) {
-
-                            // update best match value and indices if better match is found
-                            const double& metricValue = metricMatrix[iRecoJet][iSecondary];
-
-                            if (!std::isnan(metricValue)) {
-                                if ((metricValue < bestMatchMetricValue) || (std::isnan(bestMatchMetricValue))) {
-                                    bestMatchPrimaryIndex = iRecoJet;
-                                    bestMatchSecondaryIndex = iSecondary;
-                                    bestMatchMetricValue = metricValue;
-                                }
-                            }
-
-                        } // end for (primaryElements)
-                    } // end for (secondaryElements)
-
-                    // if no best match is found, all primary elements have been matched -> exit
-                    if (std::isnan(bestMatchMetricValue))
-                        break;
-
-                    matchResult.emplace_back(bestMatchPrimaryIndex, bestMatchSecondaryIndex);
-
-                    // return early if we reached the maximum number of allowed matched
-                    if ((this->maxMatches_ > 0) && (matchResult.size() >= this->maxMatches_)) {
-                        return matchResult;
-                    }
-
-                    // disallow further matches invoving these indices
-                    for (size_t iPrimary = 0; iPrimary < primaryCollection.size(); ++iPrimary) {
-                        metricMatrix[iPrimary][bestMatchSecondaryIndex] = std::numeric_limits<double>::quiet_NaN();
-                    }
-                    for (size_t iSecondary = 0; iSecondary < secondaryCollection.size(); ++iSecondary) {
-                        metricMatrix[bestMatchPrimaryIndex][iSecondary] = std::numeric_limits<double>::quiet_NaN();
-                    }
-
-                } // end for (iterations)
+                greedyPairAssignment_.assign(primaryCollection.size(), secondaryCollection.size(), maxMatches_, matchResult);
 
             } // end if (empty)
 
-            return matchResult;
+        };
 
+        /** Value of the metric for a primary-secondary pair, as used for matching */
+        double metricValue(const typename TPrimaryCollection::value_type& primaryElement,
+                           const typename TSecondaryCollection::value_type& secondaryElement) const {
+            return metricFunctor_(secondaryElement.p4, primaryElement.p4);
         };
 
+        const size_t maxMatches_;
+        const bool allowIdenticalIndices_;
         const double maxMetricValue_;
         const MetricFunctor metricFunctor_;
+
+      private:
+        // optional spatial index for pruning candidate pairs
+        std::unique_ptr<EtaPhiGrid> etaPhiGrid_;
+        std::vector<size_t> candidateIndices_;
+
+        GreedyPairAssignment greedyPairAssignment_;
     };
 
 
     /**
-     * MetricThresholdMatcher
+     * StaticMetricThresholdMatcher
      *   - finds matches among all possible pairs of objects in primary and secondary collections
      *   - pairs are matched if the metric value is _below_ a configured threshold
      *   - if a metric value is 'nan', that match is vetoed
@@ -152,47 +462,65 @@ namespace karma {
      *     for which the metric is below threshold)
      */
     template<typename TPrimaryCollection, typename TSecondaryCollection, typename MetricFunctor>
-    class MetricThresholdMatcher : public GenericMatcher<TPrimaryCollection, TSecondaryCollection> {
+    class StaticMetricThresholdMatcher {
 
       public:
-        MetricThresholdMatcher(double maxMetricValue, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
-            GenericMatcher<TPrimaryCollection, TSecondaryCollection>(maxMatches, allowIdenticalIndices),
+        StaticMetricThresholdMatcher(double maxMetricValue, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            maxMatches_(maxMatches),
+            allowIdenticalIndices_(allowIdenticalIndices),
             maxMetricValue_(maxMetricValue),
             metricFunctor_(MetricFunctor()) {};
-        MetricThresholdMatcher(const MetricFunctor metricFunctor, double maxMetricValue, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
-            GenericMatcher<TPrimaryCollection, TSecondaryCollection>(maxMatches, allowIdenticalIndices),
+        StaticMetricThresholdMatcher(const MetricFunctor metricFunctor, double maxMetricValue, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            maxMatches_(maxMatches),
+            allowIdenticalIndices_(allowIdenticalIndices),
             maxMetricValue_(maxMetricValue),
             metricFunctor_(metricFunctor) {};
 
-        virtual std::vector<std::pair<int, int>> match(
-                const TPrimaryCollection& primaryCollection, const TSecondaryCollection& secondaryCollection) {
+        /** Use an eta-phi grid to only consider nearby pairs (DeltaR metric only) */
+        void enableEtaPhiGrid() {
+            static_assert(std::is_same<MetricFunctor, DeltaRFunctor>::value, "Eta-phi grid requires DeltaR metric!");
+            etaPhiGrid_.reset(new EtaPhiGrid(maxMetricValue_));
+        };
 
-            std::vector<std::pair<int, int>> matchResult;
+        void match(const TPrimaryCollection& primaryCollection, const TSecondaryCollection& secondaryCollection,
+                   std::vector<std::pair<int, int>>& matchResult) {
+
+            matchResult.clear();
 
             // do matching only if collections are not empty
             if ((primaryCollection.size() != 0) && (secondaryCollection.size() != 0)) {
 
+                // if available and worthwhile, use the eta-phi grid to only consider nearby secondaries
+                const bool useGrid = (etaPhiGrid_ && etaPhiGrid_->fill(secondaryCollection, primaryCollection.size()));
+
                 for (size_t iPrimary = 0; iPrimary < primaryCollection.size(); ++iPrimary) {
-                    for (size_t iSecondary = 0; iSecondary < secondaryCollection.size(); ++iSecondary) {
+
+                    if (useGrid) {
+                        etaPhiGrid_->getCandidates(primaryCollection[iPrimary].p4, candidateIndices_);
+                    }
+                    const size_t nCandidates = useGrid ? candidateIndices_.size() : secondaryCollection.size();
+
+                    for (size_t iCandidate = 0; iCandidate < nCandidates; ++iCandidate) {
+                        const size_t iSecondary = useGrid ? candidateIndices_[iCandidate] : iCandidate;
 
                         // skip this pairing if indices are the same and matching them is not allowed
-                        if ((!this->allowIdenticalIndices_) && (iPrimary == iSecondary)) {
+                        if ((!allowIdenticalIndices_) && (iPrimary == iSecondary)) {
                             continue;
                         }
 
                         double metricValue = metricFunctor_(
-                            primaryCollection.at(iPrimary).p4,
-                            secondaryCollection.at(iSecondary).p4
+                            primaryCollection[iPrimary].p4,
+                            secondaryCollection[iSecondary].p4
                         );
 
                         // match *every* object within configured max metric value
                         if (metricValue <= maxMetricValue_) {
                             matchResult.emplace_back(iPrimary, iSecondary);
-                        }
 
-                        // return early if we reached the maximum number of allowed matched
-                        if ((this->maxMatches_ > 0) && (matchResult.size() >= this->maxMatches_)) {
-                            return matchResult;
+                            // return early if we reached the maximum number of allowed matched
+                            if ((maxMatches_ > 0) && (matchResult.size() >= maxMatches_)) {
+                                return;
+                            }
                         }
 
                     } // end for (secondaryElements)
@@ -201,36 +529,321 @@ namespace karma {
 
             } // end if (empty)
 
-            return matchResult;
+        };
 
+        /** Value of the metric for a primary-secondary pair, as used for matching */
+        double metricValue(const typename TPrimaryCollection::value_type& primaryElement,
+                           const typename TSecondaryCollection::value_type& secondaryElement) const {
+            return metricFunctor_(primaryElement.p4, secondaryElement.p4);
         };
 
+        const size_t maxMatches_;
+        const bool allowIdenticalIndices_;
         const double maxMetricValue_;
         const MetricFunctor metricFunctor_;
+
+      private:
+        // optional spatial index for pruning candidate pairs
+        std::unique_ptr<EtaPhiGrid> etaPhiGrid_;
+        std::vector<size_t> candidateIndices_;
     };
 
-    // -- metric functors
+    /**
+     * StaticCachedDeltaRMatcherBase
+     *   - common base for DeltaR matchers using cached eta/phi arrays of both collections
+     *   - the DeltaR^2 matrix is computed row by row and compared to the squared threshold;
+     *     only pairs close to the threshold are checked with the exact (square-rooted) value,
+     *     so that decisions are identical to those made using `DeltaRFunctor`
+     */
+    template<typename TPrimaryCollection, typename TSecondaryCollection>
+    class StaticCachedDeltaRMatcherBase {
+
+      public:
+        StaticCachedDeltaRMatcherBase(double maxDeltaR, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            maxMatches_(maxMatches),
+            allowIdenticalIndices_(allowIdenticalIndices),
+            maxDeltaR_(maxDeltaR),
+            // slightly enlarged to account for rounding of the square
+            maxDeltaR2_(maxDeltaR * maxDeltaR * (1.0 + 1e-12)) {};
+
+        /** Value of the metric (DeltaR) for a primary-secondary pair */
+        double metricValue(const typename TPrimaryCollection::value_type& primaryElement,
+                           const typename TSecondaryCollection::value_type& secondaryElement) const {
+            return DeltaRFunctor()(primaryElement.p4, secondaryElement.p4);
+        };
+
+        const size_t maxMatches_;
+        const bool allowIdenticalIndices_;
+        const double maxDeltaR_;
+
+      protected:
+        /**
+         * Fill the secondary cache and compute the DeltaR^2 matrix (row-major, one row per primary).
+         * The primary eta/phi arrays are passed in, so they can be shared between several matchers.
+         */
+        void computeDeltaR2Matrix(const EtaPhiCache& primaryCache, const TSecondaryCollection& secondaryCollection) {
+            secondaryCache_.fill(secondaryCollection);
+
+            const size_t nSecondary = secondaryCache_.size();
+            deltaR2Matrix_.resize(primaryCache.size() * nSecondary);
+            for (size_t iPrimary = 0; iPrimary < primaryCache.size(); ++iPrimary) {
+                computeDeltaR2(
+                    primaryCache.eta()[iPrimary], primaryCache.phi()[iPrimary],
+                    secondaryCache_.eta(), secondaryCache_.phi(), nSecondary,
+                    &deltaR2Matrix_[iPrimary * nSecondary]
+                );
+            }
+        };
+
+        /** True if pair is within the max. DeltaR (false for vetoed pairs) */
+        bool isWithinMaxDeltaR(size_t iPrimary, size_t iSecondary) const {
+            // skip this pairing if indices are the same and matching them is not allowed
+            if ((!allowIdenticalIndices_) && (iPrimary == iSecondary)) {
+                return false;
+            }
+            const double deltaR2 = deltaR2Matrix_[iPrimary * secondaryCache_.size() + iSecondary];
+            // note: 'nan' values fail the comparison and are vetoed
+            return (deltaR2 <= maxDeltaR2_) && (std::sqrt(deltaR2) <= maxDeltaR_);
+        };
+
+        double deltaR(size_t iPrimary, size_t iSecondary) const {
+            return std::sqrt(deltaR2Matrix_[iPrimary * secondaryCache_.size() + iSecondary]);
+        };
+
+        // cache for the primary collection if not provided by the caller
+        EtaPhiCache primaryCache_;
+
+      private:
+        const double maxDeltaR2_;
+
+        EtaPhiCache secondaryCache_;
+        std::vector<double> deltaR2Matrix_;
+    };
 
     /**
-     * Functor operates on LVs and returns DeltaR
+     * StaticCachedLowestDeltaRMatcher
+     *   - same results as `StaticLowestDeltaRMatcher`, but using cached eta/phi arrays
      */
-    struct DeltaRFunctor {
-        double operator()(const karma::LorentzVector& v1, const karma::LorentzVector& v2) const {
-            return ROOT::Math::VectorUtil::DeltaR(v1, v2);
-        }
+    template<typename TPrimaryCollection, typename TSecondaryCollection = TPrimaryCollection>
+    class StaticCachedLowestDeltaRMatcher : public StaticCachedDeltaRMatcherBase<TPrimaryCollection, TSecondaryCollection> {
+
+      public:
+        StaticCachedLowestDeltaRMatcher(double maxDeltaR, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            StaticCachedDeltaRMatcherBase<TPrimaryCollection, TSecondaryCollection>(maxDeltaR, maxMatches, allowIdenticalIndices) {};
+
+        void match(const TPrimaryCollection& primaryCollection, const TSecondaryCollection& secondaryCollection,
+                   std::vector<std::pair<int, int>>& matchResult) {
+            this->primaryCache_.fill(primaryCollection);
+            match(this->primaryCache_, secondaryCollection, matchResult);
+        };
+
+        /** Same as above, with eta/phi of the primary collection precomputed by the caller */
+        void match(const EtaPhiCache& primaryCache, const TSecondaryCollection& secondaryCollection,
+                   std::vector<std::pair<int, int>>& matchResult) {
+
+            matchResult.clear();
+
+            // do matching only if collections are not empty
+            if ((primaryCache.size() != 0) && (secondaryCollection.size() != 0)) {
+
+                this->computeDeltaR2Matrix(primaryCache, secondaryCollection);
+
+                greedyPairAssignment_.clear();
+                for (size_t iPrimary = 0; iPrimary < primaryCache.size(); ++iPrimary) {
+                    for (size_t iSecondary = 0; iSecondary < secondaryCollection.size(); ++iSecondary) {
+                        if (this->isWithinMaxDeltaR(iPrimary, iSecondary)) {
+                            greedyPairAssignment_.addCandidate(this->deltaR(iPrimary, iSecondary), iPrimary, iSecondary);
+                        }
+                    }
+                }
+
+                greedyPairAssignment_.assign(primaryCache.size(), secondaryCollection.size(), this->maxMatches_, matchResult);
+            }
+        };
+
+      private:
+        GreedyPairAssignment greedyPairAssignment_;
     };
 
     /**
-     * Functor operates on LVs and returns the absolute value of the difference
-     * between the invariant mass of the LVs and a reference invariant mass
-     * value. The reference mass is a parameter of the functor.
+     * StaticCachedDeltaRThresholdMatcher
+     *   - same results as `StaticDeltaRThresholdMatcher`, but using cached eta/phi arrays
      */
-    struct AbsDeltaInvariantMassFunctor {
-        AbsDeltaInvariantMassFunctor(double targetInvariantMass) : targetInvariantMass_(targetInvariantMass) {};
-        double targetInvariantMass_;
-        double operator()(const karma::LorentzVector& v1, const karma::LorentzVector& v2) const {
-            return std::abs(targetInvariantMass_ - ROOT::Math::VectorUtil::InvariantMass(v1, v2));
-        }
+    template<typename TPrimaryCollection, typename TSecondaryCollection = TPrimaryCollection>
+    class StaticCachedDeltaRThresholdMatcher : public StaticCachedDeltaRMatcherBase<TPrimaryCollection, TSecondaryCollection> {
+
+      public:
+        StaticCachedDeltaRThresholdMatcher(double maxDeltaR, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            StaticCachedDeltaRMatcherBase<TPrimaryCollection, TSecondaryCollection>(maxDeltaR, maxMatches, allowIdenticalIndices) {};
+
+        void match(const TPrimaryCollection& primaryCollection, const TSecondaryCollection& secondaryCollection,
+                   std::vector<std::pair<int, int>>& matchResult) {
+            this->primaryCache_.fill(primaryCollection);
+            match(this->primaryCache_, secondaryCollection, matchResult);
+        };
+
+        /** Same as above, with eta/phi of the primary collection precomputed by the caller */
+        void match(const EtaPhiCache& primaryCache, const TSecondaryCollection& secondaryCollection,
+                   std::vector<std::pair<int, int>>& matchResult) {
+
+            matchResult.clear();
+
+            // do matching only if collections are not empty
+            if ((primaryCache.size() != 0) && (secondaryCollection.size() != 0)) {
+
+                this->computeDeltaR2Matrix(primaryCache, secondaryCollection);
+
+                for (size_t iPrimary = 0; iPrimary < primaryCache.size(); ++iPrimary) {
+                    for (size_t iSecondary = 0; iSecondary < secondaryCollection.size(); ++iSecondary) {
+                        // match *every* object within configured max DeltaR
+                        if (this->isWithinMaxDeltaR(iPrimary, iSecondary)) {
+                            matchResult.emplace_back(iPrimary, iSecondary);
+
+                            // return early if we reached the maximum number of allowed matched
+                            if ((this->maxMatches_ > 0) && (matchResult.size() >= this->maxMatches_)) {
+                                return;
+                            }
+                        }
+                    }
+                }
+            }
+        };
+    };
+
+    // -- static specializations
+
+    template<typename TPrimaryCollection, typename TSecondaryCollection = TPrimaryCollection>
+    class StaticLowestDeltaRMatcher : public StaticLowestMetricMatcher<
+        TPrimaryCollection, TSecondaryCollection,
+        DeltaRFunctor> {
+
+      public:
+
+        StaticLowestDeltaRMatcher(double maxDeltaR, size_t maxMatches = 0, bool allowIdenticalIndices = true, bool useEtaPhiGrid = false) :
+            StaticLowestMetricMatcher<TPrimaryCollection,
+                                      TSecondaryCollection,
+                                      DeltaRFunctor>(maxDeltaR, maxMatches, allowIdenticalIndices) {
+            if (useEtaPhiGrid) {
+                this->enableEtaPhiGrid();
+            }
+        };
+
+    };
+
+    template<typename TPrimaryCollection, typename TSecondaryCollection = TPrimaryCollection>
+    class StaticDeltaRThresholdMatcher : public StaticMetricThresholdMatcher<
+        TPrimaryCollection, TSecondaryCollection,
+        DeltaRFunctor> {
+
+      public:
+
+        StaticDeltaRThresholdMatcher(double maxDeltaR, size_t maxMatches = 0, bool allowIdenticalIndices = true, bool useEtaPhiGrid = false) :
+            StaticMetricThresholdMatcher<TPrimaryCollection,
+                                         TSecondaryCollection,
+                                         DeltaRFunctor>(maxDeltaR, maxMatches, allowIdenticalIndices) {
+            if (useEtaPhiGrid) {
+                this->enableEtaPhiGrid();
+            }
+        };
+
+    };
+
+    template<typename TPrimaryCollection, typename TSecondaryCollection = TPrimaryCollection>
+    class StaticLowestAbsDeltaInvariantMassMatcher : public StaticLowestMetricMatcher<
+        TPrimaryCollection, TSecondaryCollection,
+        AbsDeltaInvariantMassFunctor> {
+
+      public:
+
+        StaticLowestAbsDeltaInvariantMassMatcher(double targetInvariantMass, double maxDeltaInvariantMass, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            StaticLowestMetricMatcher<TPrimaryCollection,
+                                      TSecondaryCollection,
+                                      AbsDeltaInvariantMassFunctor>(AbsDeltaInvariantMassFunctor(targetInvariantMass), maxDeltaInvariantMass, maxMatches, allowIdenticalIndices) {};
+
+    };
+
+    // -- virtual interface
+
+    /**
+     * GenericMatcher
+     *   - abstract class (only for specifying interface)
+     */
+    template<typename TPrimaryCollection,
+             typename TSecondaryCollection>
+    class GenericMatcher {
+      public:
+        GenericMatcher(size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            maxMatches_(maxMatches),
+            allowIdenticalIndices_(allowIdenticalIndices) {};
+        virtual ~GenericMatcher() {};
+
+        virtual std::vector<std::pair<int, int>> match(
+            const TPrimaryCollection& primaryCollection, const TSecondaryCollection& secondaryCollection) = 0;
+
+      protected:
+          const size_t maxMatches_;
+          const bool allowIdenticalIndices_;
+    };
+
+    /**
+     * StaticMatcherWrapper
+     *   - implements the `GenericMatcher` interface by forwarding to a static matcher
+     */
+    template<typename TPrimaryCollection, typename TSecondaryCollection, typename TStaticMatcher>
+    class StaticMatcherWrapper : public GenericMatcher<TPrimaryCollection, TSecondaryCollection> {
+
+      public:
+        explicit StaticMatcherWrapper(TStaticMatcher* staticMatcher) :
+            GenericMatcher<TPrimaryCollection, TSecondaryCollection>(staticMatcher->maxMatches_, staticMatcher->allowIdenticalIndices_),
+            staticMatcher_(staticMatcher) {};
+
+        virtual std::vector<std::pair<int, int>> match(
+                const TPrimaryCollection& primaryCollection, const TSecondaryCollection& secondaryCollection) {
+            std::vector<std::pair<int, int>> matchResult;
+            staticMatcher_->match(primaryCollection, secondaryCollection, matchResult);
+            return matchResult;
+        };
+
+        TStaticMatcher& getStaticMatcher() { return *staticMatcher_; }
+
+      protected:
+        std::unique_ptr<TStaticMatcher> staticMatcher_;
+    };
+
+    // -- wrappers providing the `GenericMatcher` interface
+
+    template<typename TPrimaryCollection, typename TSecondaryCollection, typename MetricFunctor>
+    class LowestMetricMatcher : public StaticMatcherWrapper<
+        TPrimaryCollection, TSecondaryCollection,
+        StaticLowestMetricMatcher<TPrimaryCollection, TSecondaryCollection, MetricFunctor>> {
+
+      public:
+        typedef StaticLowestMetricMatcher<TPrimaryCollection, TSecondaryCollection, MetricFunctor> TStaticMatcher;
+
+        LowestMetricMatcher(double maxMetricValue, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            StaticMatcherWrapper<TPrimaryCollection, TSecondaryCollection, TStaticMatcher>(
+                new TStaticMatcher(maxMetricValue, maxMatches, allowIdenticalIndices)) {};
+
+        LowestMetricMatcher(const MetricFunctor metricFunctor, double maxMetricValue, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            StaticMatcherWrapper<TPrimaryCollection, TSecondaryCollection, TStaticMatcher>(
+                new TStaticMatcher(metricFunctor, maxMetricValue, maxMatches, allowIdenticalIndices)) {};
+    };
+
+    template<typename TPrimaryCollection, typename TSecondaryCollection, typename MetricFunctor>
+    class MetricThresholdMatcher : public StaticMatcherWrapper<
+        TPrimaryCollection, TSecondaryCollection,
+        StaticMetricThresholdMatcher<TPrimaryCollection, TSecondaryCollection, MetricFunctor>> {
+
+      public:
+        typedef StaticMetricThresholdMatcher<TPrimaryCollection, TSecondaryCollection, MetricFunctor> TStaticMatcher;
+
+        MetricThresholdMatcher(double maxMetricValue, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            StaticMatcherWrapper<TPrimaryCollection, TSecondaryCollection, TStaticMatcher>(
+                new TStaticMatcher(maxMetricValue, maxMatches, allowIdenticalIndices)) {};
+
+        MetricThresholdMatcher(const MetricFunctor metricFunctor, double maxMetricValue, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            StaticMatcherWrapper<TPrimaryCollection, TSecondaryCollection, TStaticMatcher>(
+                new TStaticMatcher(metricFunctor, maxMetricValue, maxMatches, allowIdenticalIndices)) {};
     };
 
     // -- specializations
@@ -242,10 +855,14 @@ namespace karma {
 
       public:
 
-        LowestDeltaRMatcher(double maxDeltaR, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+        LowestDeltaRMatcher(double maxDeltaR, size_t maxMatches = 0, bool allowIdenticalIndices = true, bool useEtaPhiGrid = false) :
             LowestMetricMatcher<TPrimaryCollection,
                                 TSecondaryCollection,
-                                DeltaRFunctor>(maxDeltaR, maxMatches, allowIdenticalIndices) {};
+                                DeltaRFunctor>(maxDeltaR, maxMatches, allowIdenticalIndices) {
+            if (useEtaPhiGrid) {
+                this->staticMatcher_->enableEtaPhiGrid();
+            }
+        };
 
     };
 
@@ -256,10 +873,14 @@ namespace karma {
 
       public:
 
-        DeltaRThresholdMatcher(double maxDeltaR, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+        DeltaRThresholdMatcher(double maxDeltaR, size_t maxMatches = 0, bool allowIdenticalIndices = true, bool useEtaPhiGrid = false) :
             MetricThresholdMatcher<TPrimaryCollection,
                                    TSecondaryCollection,
-                                   DeltaRFunctor>(maxDeltaR, maxMatches, allowIdenticalIndices) {};
+                                   DeltaRFunctor>(maxDeltaR, maxMatches, allowIdenticalIndices) {
+            if (useEtaPhiGrid) {
+                this->staticMatcher_->enableEtaPhiGrid();
+            }
+        };
 
     };
 
@@ -277,5 +898,31 @@ namespace karma {
 
     };
 
+    template<typename TPrimaryCollection, typename TSecondaryCollection = TPrimaryCollection>
+    class CachedLowestDeltaRMatcher : public StaticMatcherWrapper<
+        TPrimaryCollection, TSecondaryCollection,
+        StaticCachedLowestDeltaRMatcher<TPrimaryCollection, TSecondaryCollection>> {
+
+      public:
+
+        CachedLowestDeltaRMatcher(double maxDeltaR, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            StaticMatcherWrapper<TPrimaryCollection, TSecondaryCollection, StaticCachedLowestDeltaRMatcher<TPrimaryCollection, TSecondaryCollection>>(
+                new StaticCachedLowestDeltaRMatcher<TPrimaryCollection, TSecondaryCollection>(maxDeltaR, maxMatches, allowIdenticalIndices)) {};
+
+    };
+
+    template<typename TPrimaryCollection, typename TSecondaryCollection = TPrimaryCollection>
+    class CachedDeltaRThresholdMatcher : public StaticMatcherWrapper<
+        TPrimaryCollection, TSecondaryCollection,
+        StaticCachedDeltaRThresholdMatcher<TPrimaryCollection, TSecondaryCollection>> {
+
+      public:
+
+        CachedDeltaRThresholdMatcher(double maxDeltaR, size_t maxMatches = 0, bool allowIdenticalIndices = true) :
+            StaticMatcherWrapper<TPrimaryCollection, TSecondaryCollection, StaticCachedDeltaRThresholdMatcher<TPrimaryCollection, TSecondaryCollection>>(
+                new StaticCachedDeltaRThresholdMatcher<TPrimaryCollection, TSecondaryCollection>(maxDeltaR, maxMatches, allowIdenticalIndices)) {};
+
+    };
+
 
 }  // end namespace
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/regex.hpp>
+
+
+namespace karma {
+
+    /**
+     * Trigger paths of a menu resolved against a list of requested
+     * (unversioned) path names.
+     */
+    struct ResolvedTriggerPaths {
+        std::vector<std::string> unversionedNames;  // unversioned name of each path in the menu (empty if not an HLT path)
+        std::vector<int> indicesInConfig;  // index of each path in the list of requested paths (-1 if not requested)
+    };
+
+    /**
+     * Job-wide registry for resolving trigger path names, shared by all modules.
+     *
+     * Regular expressions are compiled once per job and the results of matching
+     * the paths of a trigger menu are memoized per menu name, so that modules
+     * with the same configuration only do this once, even if the work is
+     * repeated in each `globalBeginRun`. Since the same menu name could in
+     * principle come with a different list of paths (e.g. skims with different
+     * path selections), the path names are compared before reusing a result.
+     *
+     * All methods are thread-safe.
+     */
+    class TriggerMenuRegistry {
+
+      public:
+        /** Access the registry instance */
+        static karma::TriggerMenuRegistry& instance();
+
+        /**
+         * Return the indices of the paths in `pathNames` that match at least
+         * one of the regular expressions in `regexes` (case-insensitive, POSIX extended)
+         */
+        std::shared_ptr<const std::vector<size_t>> matchPaths(
+            const std::string& menuName, const std::vector<std::string>& pathNames, const std::vector<std::string>& regexes);
+
+        /**
+         * Strip the version suffix from the paths in `pathNames` and return
+         * the unversioned names and their indices in `requestedPaths`
+         */
+        std::shared_ptr<const karma::ResolvedTriggerPaths> resolvePaths(
+            const std::string& menuName, const std::vector<std::string>& pathNames, const std::vector<std::string>& requestedPaths);
+
+        /** Return the name of an HLT path without the version suffix, or an empty string for non-HLT paths */
+        static std::string unversionedName(const std::string& pathName);
+
+        // -- cache statistics
+        size_t numCacheHits() const;
+        size_t numCacheMisses() const;
+
+      private:
+        TriggerMenuRegistry() {};
+        TriggerMenuRegistry(const TriggerMenuRegistry&) = delete;
+        TriggerMenuRegistry& operator=(const TriggerMenuRegistry&) = delete;
+
+        template<typename TResult>
+        struct CacheEntry {
+            std::vector<std::string> pathNames;
+            std::shared_ptr<const TResult> result;
+        };
+
+        const boost::regex& getRegex(const std::string& regexString);
+
+        mutable std::mutex mutex_;
+
+        std::map<std::string, boost::regex> regexes_;  // compiled regular expressions by pattern
+        std::map<std::string, CacheEntry<std::vector<size_t>>> matchedPaths_;  // by menu name and regexes
+        std::map<std::string, CacheEntry<karma::ResolvedTriggerPaths>> resolvedPaths_;  // by menu name and requested paths
+
+        size_t numCacheHits_ = 0;
+        size_t numCacheMisses_ = 0;
+
+    };
+
+}  // end namespace
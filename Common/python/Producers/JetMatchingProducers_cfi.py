@@ -10,6 +10,10 @@ karmaJetTriggerObjectMatchingProducer = cms.EDProducer(
 
         # -- other configuration
         maxDeltaR = cms.double(0.2),
+        # bucket secondaries in an eta-phi grid to avoid evaluating all pairs (identical results)
+        useEtaPhiGrid = cms.bool(True),
+        # also store a compact index-based association (karma::IndexAssociation)
+        produceIndexAssociation = cms.bool(False),
     )
 )
 
@@ -22,6 +26,8 @@ karmaJetMuonMatchingProducer = cms.EDProducer(
 
         # -- other configuration
         maxDeltaR = cms.double(0.4),
+        useEtaPhiGrid = cms.bool(True),
+        produceIndexAssociation = cms.bool(False),
     )
 )
 
@@ -34,6 +40,8 @@ karmaJetElectronMatchingProducer = cms.EDProducer(
 
         # -- other configuration
         maxDeltaR = cms.double(0.4),
+        useEtaPhiGrid = cms.bool(True),
+        produceIndexAssociation = cms.bool(False),
     )
 )
 
@@ -46,5 +54,46 @@ karmaJetGenJetMatchingProducer = cms.EDProducer(
 
         # -- other configuration
         maxDeltaR = cms.double(0.2),
+        useEtaPhiGrid = cms.bool(True),
+        produceIndexAssociation = cms.bool(False),
+    )
+)
+
+# match jets to several collections in one module (jet kinematics computed once per event);
+# associations are stored under the product instance label given by 'name' and are
+# identical to those of the producers above unless a different 'metric' is configured
+karmaJetMultiMatchingProducer = cms.EDProducer(
+    "KarmaJetMultiMatchingProducer",
+    cms.PSet(
+        # -- input sources
+        primaryCollectionSrc = cms.InputTag("karmaUpdatedPatJetsNoJEC"),
+
+        # also store a compact index-based association (karma::IndexAssociation) per secondary collection
+        produceIndexAssociation = cms.bool(False),
+
+        # -- secondary collections ('type' is one of 'TriggerObject', 'Muon', 'Electron', 'LV')
+        #    optional 'metric': 'deltaRThreshold' (all within maxDeltaR; default except for 'LV')
+        #                    or 'lowestDeltaR' (closest pairs first, injective; default and only option for 'LV')
+        secondaryCollections = cms.VPSet(
+            cms.PSet(
+                name = cms.string("TriggerObjects"),
+                type = cms.string("TriggerObject"),
+                src = cms.InputTag("karmaTriggerObjects"),
+                maxDeltaR = cms.double(0.2),
+                metric = cms.string("deltaRThreshold"),
+            ),
+            cms.PSet(
+                name = cms.string("Muons"),
+                type = cms.string("Muon"),
+                src = cms.InputTag("karmaMuons"),
+                maxDeltaR = cms.double(0.4),
+            ),
+            cms.PSet(
+                name = cms.string("Electrons"),
+                type = cms.string("Electron"),
+                src = cms.InputTag("karmaElectrons"),
+                maxDeltaR = cms.double(0.4),
+            ),
+        ),
     )
 )
@@ -0,0 +1,71 @@
+#!/usr/bin/env python
+"""
+Compare the time per event spent in CMSSW modules between two cmsRun logs
+written with the `Timing` service (`summaryOnly = False`), e.g. for the same
+configuration run at two revisions of the code:
+
+    compareModuleTiming.py timing_baseline.log timing_head.log --modules karmaGenParticles karmaTriggerObjects
+
+For every module, the average time per event (in microseconds) in both logs
+and the ratio (second / first) are printed.
+"""
+from __future__ import print_function
+
+import argparse
+import sys
+
+from collections import OrderedDict
+
+
+def read_module_times(log_file_name):
+    """Return the list of per-event times (in seconds) for each module label in a log file."""
+    _times = OrderedDict()
+    with open(log_file_name) as _f:
+        for _line in _f:
+            # format: 'TimeModule> <event> <run> <module label> <module type> <time in s>'
+            if not _line.startswith('TimeModule>'):
+                continue
+            _fields = _line.split()
+            if len(_fields) < 6:
+                continue
+            _times.setdefault(_fields[3], []).append(float(_fields[5]))
+    return _times
+
+
+if __name__ == "__main__":
+
+    _parser = argparse.ArgumentParser(description="Compare per-module timings in two cmsRun logs (Timing service).")
+    _parser.add_argument('first_log', help="log file of the first (baseline) job")
+    _parser.add_argument('second_log', help="log file of the second job")
+    _parser.add_argument('--modules', nargs='+', default=None, help="module labels to compare (default: all modules starting with 'karma')")
+    _args = _parser.parse_args()
+
+    _first_times = read_module_times(_args.first_log)
+    _second_times = read_module_times(_args.second_log)
+
+    _modules = _args.modules
+    if _modules is None:
+        _modules = sorted(set(_m for _m in list(_first_times) + list(_second_times) if _m.startswith('karma')))
+
+    if not _modules:
+        print("[ERROR] No 'TimeModule>' lines found for the requested modules!")
+        sys.exit(1)
+
+    _colsize = max(len(_m) for _m in _modules)
+    print("{{:{}s}} {{:>8s}} {{:>14s}} {{:>8s}} {{:>14s}} {{:>8s}}".format(_colsize).format(
+        'module', 'events', 'first [us]', 'events', 'second [us]', 'ratio'))
+
+    _missing = False
+    for _m in _modules:
+        _first = _first_times.get(_m, [])
+        _second = _second_times.get(_m, [])
+        if not _first or not _second:
+            print("{{:{}s}} not found in {{}}".format(_colsize).format(_m, "either log" if not (_first or _second) else "one of the logs"))
+            _missing = True
+            continue
+        _first_avg = 1e6 * sum(_first) / len(_first)
+        _second_avg = 1e6 * sum(_second) / len(_second)
+        print("{{:{}s}} {{:8d}} {{:14.1f}} {{:8d}} {{:14.1f}} {{:8.3f}}".format(_colsize).format(
+            _m, len(_first), _first_avg, len(_second), _second_avg, _second_avg / _first_avg if _first_avg else float('nan')))
+
+    sys.exit(1 if _missing else 0)
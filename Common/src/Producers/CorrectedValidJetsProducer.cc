@@ -79,6 +79,7 @@ karma::CorrectedValidJetsProducer::CorrectedValidJetsProducer(const edm::Paramet
         }
         std::cout << "[CorrectedValidJetsProducer]   - " << jecUncertaintySource << std::endl;
         m_jetUncertaintySourceNames.push_back(jecUncertaintySource);
+        m_jetUncertaintySourceKeys.emplace_back(jecUncertaintySource);
         m_jetUncertaintySourceShifts.push_back(1.0);  // future: make configurable?
         m_jetUncertaintySourceCorrectors.emplace_back(
             std::unique_ptr<JetCorrectionUncertainty>(
@@ -202,11 +203,11 @@ void karma::CorrectedValidJetsProducer::produce(edm::Event& event, const edm::Ev
 
         // store L1-corrected p4 in transient map
         setupFactorizedJetCorrector(*jetCorrectorL1, *this->karmaEventHandle, inputJet);
-        outputJetCollection->back().transientLVs_["L1"] = outputJetCollection->back().uncorP4 * jetCorrectorL1->getCorrection();
+        outputJetCollection->back().transientLVs_[m_transientKeyL1] = outputJetCollection->back().uncorP4 * jetCorrectorL1->getCorrection();
 
         // store L1RC-corrected p4 in transient map
         setupFactorizedJetCorrector(*jetCorrectorL1RC, *this->karmaEventHandle, inputJet);
-        outputJetCollection->back().transientLVs_["L1RC"] = outputJetCollection->back().uncorP4 * jetCorrectorL1RC->getCorrection();
+        outputJetCollection->back().transientLVs_[m_transientKeyL1RC] = outputJetCollection->back().uncorP4 * jetCorrectorL1RC->getCorrection();
 
         // apply correction (if any requested)
         if (jetCorrector) {
@@ -225,14 +226,14 @@ void karma::CorrectedValidJetsProducer::produce(edm::Event& event, const edm::Ev
         // store P4 shift factors for named uncertainty sources in transient list of doubles
         for (size_t iUnc = 0; iUnc < m_jetUncertaintySourceCorrectors.size(); ++iUnc) {
             setupFactorProvider(*m_jetUncertaintySourceCorrectors[iUnc], inputJet);
-            outputJetCollection->back().transientDoubles_[m_jetUncertaintySourceNames[iUnc]] = (
+            outputJetCollection->back().transientDoubles_[m_jetUncertaintySourceKeys[iUnc]] = (
                 m_jetUncertaintySourceShifts[iUnc] * m_jetUncertaintySourceCorrectors[iUnc]->getUncertainty(
                     /*bool direction = */ m_jetUncertaintySourceShifts[iUnc] > 0.0));
         }
 
         // also store Total P4 shift factors transient list of doubles
         setupFactorProvider(*jetCorrectionUncertainty, inputJet);
-        outputJetCollection->back().transientDoubles_["Total"] = jetCorrectionUncertainty->getUncertainty(/*bool direction = */ true);
+        outputJetCollection->back().transientDoubles_[m_transientKeyTotal] = jetCorrectionUncertainty->getUncertainty(/*bool direction = */ true);
 
     }
 
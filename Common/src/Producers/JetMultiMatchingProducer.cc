@@ -0,0 +1,77 @@
+// system include files
+
+#include "Karma/Common/interface/Producers/JetMultiMatchingProducer.h"
+
+
+// -- constructor
+karma::JetMultiMatchingProducer::JetMultiMatchingProducer(const edm::ParameterSet& config) : m_configPSet(config) {
+
+    // -- process configuration
+    m_produceIndexAssociation = m_configPSet.getParameter<bool>("produceIndexAssociation");
+
+    // -- one matching task (and product) per secondary collection
+    const auto& secondaryCollectionPSets = m_configPSet.getParameter<std::vector<edm::ParameterSet>>("secondaryCollections");
+    for (const auto& secondaryCollectionPSet : secondaryCollectionPSets) {
+        const auto& type = secondaryCollectionPSet.getParameter<std::string>("type");
+
+        // matching metric (default: same as the corresponding single-collection producer)
+        const std::string defaultMetric = (type == "LV") ? "lowestDeltaR" : "deltaRThreshold";
+        const std::string metric = secondaryCollectionPSet.existsAs<std::string>("metric") ?
+            secondaryCollectionPSet.getParameter<std::string>("metric") : defaultMetric;
+
+        if (type == "TriggerObject")
+            addMatchingTask<karma::TriggerObjectCollection, karma::JetTriggerObjectsMap>(secondaryCollectionPSet, metric);
+        else if (type == "Muon")
+            addMatchingTask<karma::MuonCollection, karma::JetMuonsMap>(secondaryCollectionPSet, metric);
+        else if (type == "Electron")
+            addMatchingTask<karma::ElectronCollection, karma::JetElectronsMap>(secondaryCollectionPSet, metric);
+        else if (type == "LV") {
+            // one-to-one association: at most one secondary per jet
+            if (metric != "lowestDeltaR")
+                throw edm::Exception(
+                    edm::errors::ConfigFileReadError,
+                    "[JetMultiMatchingProducer] Invalid value '" + metric + "' for 'metric' parameter: "
+                    "type 'LV' produces a one-to-one association and requires 'lowestDeltaR'."
+                );
+            addMatchingTask<karma::LVCollection, karma::JetGenJetMap>(secondaryCollectionPSet, metric);
+        }
+        else
+            throw edm::Exception(
+                edm::errors::ConfigFileReadError,
+                "[JetMultiMatchingProducer] Invalid value '" + type + "' for 'type' parameter. "
+                "Expected one of: 'TriggerObject', 'Muon', 'Electron', 'LV'."
+            );
+    }
+
+    // -- declare which collections are consumed and create tokens
+    jetCollectionToken = consumes<karma::JetCollection>(m_configPSet.getParameter<edm::InputTag>("primaryCollectionSrc"));
+}
+
+
+// -- member functions
+
+void karma::JetMultiMatchingProducer::produce(edm::Event& event, const edm::EventSetup& setup) {
+
+    // -- retrieve jet collection and compute kinematics once for all matching tasks
+    karma::util::getByTokenOrThrow(event, this->jetCollectionToken, this->jetCollectionHandle);
+    m_jetEtaPhiCache.fill(*this->jetCollectionHandle);
+
+    // -- match to each secondary collection and put products into the event
+    for (const auto& matchingTask : m_matchingTasks) {
+        matchingTask->produce(event, this->jetCollectionHandle, m_jetEtaPhiCache);
+    }
+}
+
+
+void karma::JetMultiMatchingProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+    // The following says we do not know what parameters are allowed so do no validation
+    // Please change this to state exactly what you do use, even if it is no parameters
+    edm::ParameterSetDescription desc;
+    desc.setUnknown();
+    descriptions.addDefault(desc);
+}
+
+
+//define this as a plug-in
+using KarmaJetMultiMatchingProducer = karma::JetMultiMatchingProducer;
+DEFINE_FWK_MODULE(KarmaJetMultiMatchingProducer);
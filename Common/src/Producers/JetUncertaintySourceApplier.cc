@@ -9,6 +9,9 @@ karma::JetUncertaintySourceApplier::JetUncertaintySourceApplier(const edm::Param
 
     // retrieve the uncertainty names
     m_jetUncertaintySourceNames = m_configPSet.getParameter<std::vector<std::string>>("jetUncertaintySources");
+    for (const auto& jetUncertaintySourceName : m_jetUncertaintySourceNames) {
+        m_jetUncertaintySourceKeys.emplace_back(jetUncertaintySourceName);
+    }
 
     // -- declare which collections are consumed and create tokens
     karmaJetCollectionToken = consumes<karma::JetCollection>(m_configPSet.getParameter<edm::InputTag>("karmaJetCollectionSrc"));
@@ -40,11 +43,11 @@ void karma::JetUncertaintySourceApplier::produce(edm::Event& event, const edm::E
         outputJetCollection->push_back(inputJet);
 
         // potentially reverse the shift by the "Total" JEU (always safe to do this; if not applied factor is 1.0)
-        outputJetCollection->back().p4 /= outputJetCollection->back().transientDoubles_["Total"];
+        outputJetCollection->back().p4 /= outputJetCollection->back().transientDoubles_[m_transientKeyTotal];
 
         // apply the requested JES uncertainty source shift(s)
-        for (const auto& jetUncertaintySourceName : m_jetUncertaintySourceNames) {
-            outputJetCollection->back().p4 *= outputJetCollection->back().transientDoubles_[jetUncertaintySourceName];
+        for (const auto& jetUncertaintySourceKey : m_jetUncertaintySourceKeys) {
+            outputJetCollection->back().p4 *= outputJetCollection->back().transientDoubles_[jetUncertaintySourceKey];
         }
     }
 
@@ -144,8 +144,8 @@ void karma::SmearedJetsProducer::produce(edm::Event& event, const edm::EventSetu
 
         // apply smearing factor (and store further information in transient map)
         outputJetCollection->back().p4 *= smearingFactor;
-        outputJetCollection->back().transientDoubles_["JERScaleFactor"] = resolutionSF;
-        outputJetCollection->back().transientDoubles_["JERSmearingFactor"] = smearingFactor;
+        outputJetCollection->back().transientDoubles_[m_transientKeyJERScaleFactor] = resolutionSF;
+        outputJetCollection->back().transientDoubles_[m_transientKeyJERSmearingFactor] = smearingFactor;
     }
 
     // re-sort jets by pT
@@ -0,0 +1,118 @@
+#include "Karma/Common/interface/Tools/TriggerMenuRegistry.h"
+
+#include <algorithm>
+
+namespace {
+    // key for memoizing results: menu name followed by the configuration strings
+    std::string makeCacheKey(const std::string& menuName, const std::vector<std::string>& configStrings) {
+        std::string key = menuName;
+        for (const auto& configString : configStrings) {
+            key += '\n';
+            key += configString;
+        }
+        return key;
+    }
+}  // end namespace
+
+
+/*static*/ karma::TriggerMenuRegistry& karma::TriggerMenuRegistry::instance() {
+    static karma::TriggerMenuRegistry registry;
+    return registry;
+}
+
+
+/*static*/ std::string karma::TriggerMenuRegistry::unversionedName(const std::string& pathName) {
+    static const boost::regex hltVersionPattern("(HLT_.*)_v[0-9]+", boost::regex::extended);
+
+    boost::smatch matchedSubstrings;
+    if (boost::regex_match(pathName, matchedSubstrings, hltVersionPattern) && matchedSubstrings.size() > 1) {
+        // need matchedSubstrings[1] because matchedSubstrings[0] is always the entire string
+        return matchedSubstrings[1];
+    }
+    return "";
+}
+
+
+const boost::regex& karma::TriggerMenuRegistry::getRegex(const std::string& regexString) {
+    // note: caller must hold the lock
+    auto it = regexes_.find(regexString);
+    if (it == regexes_.end()) {
+        it = regexes_.emplace(regexString, boost::regex(regexString, boost::regex::icase | boost::regex::extended)).first;
+    }
+    return it->second;
+}
+
+
+std::shared_ptr<const std::vector<size_t>> karma::TriggerMenuRegistry::matchPaths(
+        const std::string& menuName, const std::vector<std::string>& pathNames, const std::vector<std::string>& regexes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto& cacheEntry = matchedPaths_[makeCacheKey(menuName, regexes)];
+    if (cacheEntry.result && (cacheEntry.pathNames == pathNames)) {
+        ++numCacheHits_;
+        return cacheEntry.result;
+    }
+    ++numCacheMisses_;
+
+    std::vector<const boost::regex*> compiledRegexes;
+    for (const auto& regexString : regexes) {
+        compiledRegexes.push_back(&getRegex(regexString));
+    }
+
+    auto matchedPathIndices = std::make_shared<std::vector<size_t>>();
+    for (size_t iPath = 0; iPath < pathNames.size(); ++iPath) {
+        const std::string& pathName = pathNames[iPath];
+        const bool regexMatch = std::any_of(
+            compiledRegexes.begin(), compiledRegexes.end(),
+            [&pathName](const boost::regex* regex) { return boost::regex_search(pathName, *regex); }
+        );
+        if (regexMatch) {
+            matchedPathIndices->push_back(iPath);
+        }
+    }
+
+    cacheEntry.pathNames = pathNames;
+    cacheEntry.result = matchedPathIndices;
+    return cacheEntry.result;
+}
+
+
+std::shared_ptr<const karma::ResolvedTriggerPaths> karma::TriggerMenuRegistry::resolvePaths(
+        const std::string& menuName, const std::vector<std::string>& pathNames, const std::vector<std::string>& requestedPaths) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto& cacheEntry = resolvedPaths_[makeCacheKey(menuName, requestedPaths)];
+    if (cacheEntry.result && (cacheEntry.pathNames == pathNames)) {
+        ++numCacheHits_;
+        return cacheEntry.result;
+    }
+    ++numCacheMisses_;
+
+    auto resolvedPaths = std::make_shared<karma::ResolvedTriggerPaths>();
+    resolvedPaths->unversionedNames.resize(pathNames.size());
+    resolvedPaths->indicesInConfig.resize(pathNames.size(), -1);
+    for (size_t iPath = 0; iPath < pathNames.size(); ++iPath) {
+        resolvedPaths->unversionedNames[iPath] = unversionedName(pathNames[iPath]);
+
+        const auto& it = std::find(requestedPaths.begin(), requestedPaths.end(), resolvedPaths->unversionedNames[iPath]);
+        if (it != requestedPaths.end()) {
+            resolvedPaths->indicesInConfig[iPath] = std::distance(requestedPaths.begin(), it);
+        }
+    }
+
+    cacheEntry.pathNames = pathNames;
+    cacheEntry.result = resolvedPaths;
+    return cacheEntry.result;
+}
+
+
+size_t karma::TriggerMenuRegistry::numCacheHits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return numCacheHits_;
+}
+
+
+size_t karma::TriggerMenuRegistry::numCacheMisses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return numCacheMisses_;
+}
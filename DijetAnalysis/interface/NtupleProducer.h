@@ -31,6 +31,7 @@
 #include "Karma/Common/interface/Providers/JetIDProvider.h"
 #include "Karma/Common/interface/Providers/FlexGridBinProvider.h"
 #include "Karma/Common/interface/Providers/PileupWeightProvider.h"
+#include "Karma/Common/interface/Tools/TriggerMenuRegistry.h"
 
 // -- output data formats
 #include "Karma/DijetAnalysisFormats/interface/Ntuple.h"
@@ -82,8 +83,7 @@ namespace dijet {
         NtupleProducerGlobalCache(const edm::ParameterSet& pSet) :
             karma::CacheBase(pSet),
             metFilterNames_(pSet.getParameter<std::vector<std::string>>("metFilterNames")),
-            doPrescales_(pSet.getParameter<bool>("doPrescales")),
-            hltVersionPattern_(boost::regex("(HLT_.*)_v[0-9]+", boost::regex::extended)) {
+            doPrescales_(pSet.getParameter<bool>("doPrescales")) {
 
             /// // create the global trigger efficiencies provider instance
             /// triggerEfficienciesProvider_ = std::unique_ptr<karma::TriggerEfficienciesProvider>(
@@ -118,16 +118,20 @@ namespace dijet {
             const auto& flexGridFileDijetPtAve = pSet.getParameter<std::string>("flexGridFileDijetPtAve");
             if (!flexGridFileDijetPtAve.empty()) {
                 std::cout << "Reading FlexGrid binning information (pT average) from file: " << flexGridFileDijetPtAve << std::endl;
-                flexGridDijetPtAverage_ = std::unique_ptr<FlexGrid>(new FlexGrid(flexGridFileDijetPtAve));
+                std::shared_ptr<FlexGrid> flexGrid(new FlexGrid(flexGridFileDijetPtAve));
                 // assign active trigger path for each bin based on trigger turnon information
-                assignActiveTriggerPathIndices(flexGridDijetPtAverage_->_rootFlexNode, "DiPFJetAveTriggers");
+                assignActiveTriggerPathIndices(flexGrid->_rootFlexNode, "DiPFJetAveTriggers");
+                // immutable from here on, shared by all streams
+                flexGridDijetPtAverage_ = flexGrid;
             }
             const auto& flexGridFileDijetMass = pSet.getParameter<std::string>("flexGridFileDijetMass");
             if (!flexGridFileDijetMass.empty()) {
                 std::cout << "Reading FlexGrid binning information (dijet mass) from file: " << flexGridFileDijetMass << std::endl;
-                flexGridDijetDijetMass_ = std::unique_ptr<FlexGrid>(new FlexGrid(flexGridFileDijetMass));
+                std::shared_ptr<FlexGrid> flexGrid(new FlexGrid(flexGridFileDijetMass));
                 // assign active trigger path for each bin based on trigger turnon information
-                assignActiveTriggerPathIndices(flexGridDijetDijetMass_->_rootFlexNode, "DiPFJetAveTriggers");
+                assignActiveTriggerPathIndices(flexGrid->_rootFlexNode, "DiPFJetAveTriggers");
+                // immutable from here on, shared by all streams
+                flexGridDijetDijetMass_ = flexGrid;
             }
 
         };
@@ -186,7 +190,6 @@ namespace dijet {
         std::vector<std::string> metFilterNames_;  // list of MET filter names that should be written out
         bool doPrescales_;
 
-        const boost::regex hltVersionPattern_;
         std::vector<std::string> hltPaths_;
         std::vector<double> hltThresholds_;
         std::vector<double> l1Thresholds_;
@@ -197,8 +200,9 @@ namespace dijet {
         std::unique_ptr<karma::TriggerEfficienciesProvider> triggerEfficienciesProvider_;  // not used (yet?)
         std::unique_ptr<karma::JetIDProvider> jetIDProvider_;
 
-        std::unique_ptr<FlexGrid> flexGridDijetPtAverage_;
-        std::unique_ptr<FlexGrid> flexGridDijetDijetMass_;
+        // FlexGrids with final analysis binning (shared by the per-stream bin providers)
+        std::shared_ptr<const FlexGrid> flexGridDijetPtAverage_;
+        std::shared_ptr<const FlexGrid> flexGridDijetDijetMass_;
 
     };
 
@@ -262,6 +266,8 @@ namespace dijet {
         std::unique_ptr<karma::NPUMeanProvider> m_npuMeanProvider;
         std::unique_ptr<karma::FlexGridBinProvider> m_flexGridBinProviderDijetPtAve;
         std::unique_ptr<karma::FlexGridBinProvider> m_flexGridBinProviderDijetMass;
+        karma::FlexGridMetadataHandle<int> m_activeTriggerPathIndexDijetPtAve;
+        karma::FlexGridMetadataHandle<int> m_activeTriggerPathIndexDijetMass;
         std::unique_ptr<karma::PileupWeightProvider> m_puWeightProvider;
         std::unique_ptr<karma::PileupWeightProvider> m_puWeightProviderAlt;
 
@@ -307,5 +313,8 @@ namespace dijet {
         typename edm::Handle<karma::Run> karmaRunHandle;
         edm::EDGetTokenT<karma::Run> karmaRunToken;
 
+        typename edm::Handle<karma::Lumi> karmaLumiHandle;
+        edm::EDGetTokenT<karma::Lumi> karmaLumiToken;
+
     };
 }  // end namespace
@@ -30,6 +30,7 @@
 #include "Karma/Common/interface/Providers/NPUMeanProvider.h"
 #include "Karma/Common/interface/Providers/JetIDProvider.h"
 #include "Karma/Common/interface/Providers/PileupWeightProviderV2.h"
+#include "Karma/Common/interface/Tools/TriggerMenuRegistry.h"
 
 // -- output data formats
 #include "Karma/DijetAnalysisFormats/interface/NtupleV2.h"
@@ -81,8 +82,7 @@ namespace dijet {
         NtupleV2ProducerGlobalCache(const edm::ParameterSet& pSet) :
             karma::CacheBase(pSet),
             metFilterNames_(pSet.getParameter<std::vector<std::string>>("metFilterNames")),
-            doPrescales_(pSet.getParameter<bool>("doPrescales")),
-            hltVersionPattern_(boost::regex("(HLT_.*)_v[0-9]+", boost::regex::extended)) {
+            doPrescales_(pSet.getParameter<bool>("doPrescales")) {
 
             /// // create the global trigger efficiencies provider instance
             /// triggerEfficienciesProvider_ = std::unique_ptr<karma::TriggerEfficienciesProvider>(
@@ -94,6 +94,7 @@ namespace dijet {
             for (size_t iSrc = 0; iSrc < jesUncertaintySourcesCfg.size(); ++iSrc) {
                 const auto& jesUncertaintySourceCfg = jesUncertaintySourcesCfg[iSrc];
                 jesUncertaintySources_.push_back(jesUncertaintySourceCfg.getParameter<std::string>("name"));
+                jesUncertaintySourceKeys_.emplace_back(jesUncertaintySources_.back());
             }
 
             // create list of requested HLT path names
@@ -137,7 +138,11 @@ namespace dijet {
 
         std::vector<std::string> jesUncertaintySources_;
 
-        const boost::regex hltVersionPattern_;
+        // keys for the transient maps of the jets (resolved once)
+        std::vector<karma::TransientKey> jesUncertaintySourceKeys_;
+        const karma::TransientKey jerSmearingFactorKey_{"JERSmearingFactor"};
+        const karma::TransientKey jerScaleFactorKey_{"JERScaleFactor"};
+
         std::vector<std::string> hltPaths_;
         std::vector<std::string> hltPUProfileFileNames_;
         std::vector<std::string> hltPUProfileFileNamesAlt_;
@@ -262,5 +267,8 @@ namespace dijet {
         typename edm::Handle<karma::Run> karmaRunHandle;
         edm::EDGetTokenT<karma::Run> karmaRunToken;
 
+        typename edm::Handle<karma::Lumi> karmaLumiHandle;
+        edm::EDGetTokenT<karma::Lumi> karmaLumiToken;
+
     };
 }  // end namespace
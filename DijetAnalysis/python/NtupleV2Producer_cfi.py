@@ -9,6 +9,7 @@ dijetNtupleV2Producer = cms.EDProducer(
         karmaVertexCollectionSrc = cms.InputTag("karmaVertices"),
         karmaGeneratorQCDInfoSrc = cms.InputTag("karmaGeneratorQCDInfos"),
         karmaRunSrc = cms.InputTag("karmaEvents"),
+        karmaLumiSrc = cms.InputTag("karmaEvents"),
         karmaJetCollectionSrc = cms.InputTag("karmaCorrectedJets"),
         karmaMETCollectionSrc = cms.InputTag("karmaCorrectedMETs"),
         karmaGenParticleCollectionSrc = cms.InputTag("karmaGenParticles"),
@@ -139,6 +139,9 @@ dijet::NtupleV2Producer::NtupleV2Producer(const edm::ParameterSet& config, const
     // -- declare which collections are consumed and create tokens
     karmaEventToken = consumes<karma::Event>(m_configPSet.getParameter<edm::InputTag>("karmaEventSrc"));
     karmaRunToken = consumes<karma::Run, edm::InRun>(m_configPSet.getParameter<edm::InputTag>("karmaRunSrc"));
+    if (globalCache->doPrescales_) {
+        karmaLumiToken = consumes<karma::Lumi, edm::InLumi>(m_configPSet.getParameter<edm::InputTag>("karmaLumiSrc"));
+    }
     karmaVertexCollectionToken = consumes<karma::VertexCollection>(m_configPSet.getParameter<edm::InputTag>("karmaVertexCollectionSrc"));
     karmaJetCollectionToken = consumes<karma::JetCollection>(m_configPSet.getParameter<edm::InputTag>("karmaJetCollectionSrc"));
     karmaMETCollectionToken = consumes<karma::METCollection>(m_configPSet.getParameter<edm::InputTag>("karmaMETCollectionSrc"));
@@ -177,31 +180,19 @@ dijet::NtupleV2Producer::~NtupleV2Producer() {
     typename edm::Handle<karma::Run> runHandle;
     run.getByLabel(globalCache->pSet_.getParameter<edm::InputTag>("karmaRunSrc"), runHandle);
 
-    // compute the unversioned HLT path names
+    // compute the unversioned HLT path names and their indices in the analysis config
     // (needed later to get the trigger efficiencies)
-
-    runCache->triggerPathsUnversionedNames_.resize(runHandle->triggerPathInfos.size());
-    runCache->triggerPathsIndicesInConfig_.resize(runHandle->triggerPathInfos.size(), -1);
-    for (size_t iPath = 0; iPath < runHandle->triggerPathInfos.size(); ++iPath) {
-        const std::string& pathName = runHandle->triggerPathInfos[iPath].name_;
-        ///std::cout << "[Check iPath " << iPath << "] " << pathName << std::endl;
-
-        boost::smatch matched_substrings;
-        if (boost::regex_match(pathName, matched_substrings, globalCache->hltVersionPattern_) && matched_substrings.size() > 1) {
-            // need matched_substrings[1] because matched_substrings[0] is always the entire string
-            runCache->triggerPathsUnversionedNames_[iPath] = matched_substrings[1];
-            ///std::cout << " -> unversioned name: " << matched_substrings[1] << std::endl;
-        }
-
-        for (size_t iRequestedPath = 0; iRequestedPath < globalCache->hltPaths_.size(); ++iRequestedPath) {
-            ///std::cout << "[Check iRequestedPath " << iRequestedPath << "] " << globalCache->hltPaths_[iRequestedPath] << std::endl;
-            if (runCache->triggerPathsUnversionedNames_[iPath] == globalCache->hltPaths_[iRequestedPath]) {
-                ///std::cout << " -> matched! " << iPath << " = " << iRequestedPath << std::endl;
-                runCache->triggerPathsIndicesInConfig_[iPath] = iRequestedPath;
-                break;
-            }
-        }
+    // (memoized per trigger menu and shared between modules)
+    std::vector<std::string> pathNames;
+    pathNames.reserve(runHandle->triggerPathInfos.size());
+    for (const auto& pathInfo : runHandle->triggerPathInfos) {
+        pathNames.push_back(pathInfo.name_);
     }
+    const auto resolvedPaths = karma::TriggerMenuRegistry::instance().resolvePaths(
+        runHandle->triggerMenuName, pathNames, globalCache->hltPaths_);
+
+    runCache->triggerPathsUnversionedNames_ = resolvedPaths->unversionedNames;
+    runCache->triggerPathsIndicesInConfig_ = resolvedPaths->indicesInConfig;
 
     // -- retrieve names of MET filters in skim
 
@@ -380,8 +371,26 @@ void dijet::NtupleV2Producer::produce(edm::Event& event, const edm::EventSetup&
     // -- trigger results and prescales
     // number of triggers requested in analysis config
     //outputNtupleV2Entry->nTriggers = globalCache()->hltPaths_.size();
+    // prescales are looked up in the per-lumi prescale table
+    // (older skims: fall back to prescales stored in each event)
+    const std::vector<int>* triggerPathHLTPrescales = &this->karmaEventHandle->triggerPathHLTPrescales;
+    const std::vector<int>* triggerPathL1Prescales = &this->karmaEventHandle->triggerPathL1Prescales;
     if (globalCache()->doPrescales_) {
         outputNtupleV2Entry->triggerPrescales.resize(globalCache()->hltPaths_.size(), 0);
+
+        if (this->karmaEventHandle->triggerPrescaleSet >= 0) {
+            karma::util::getByTokenOrThrow(event.getLuminosityBlock(), this->karmaLumiToken, this->karmaLumiHandle);
+            const auto* prescaleColumn = this->karmaLumiHandle->findTriggerPrescaleColumn(this->karmaEventHandle->triggerPrescaleSet);
+            if (!prescaleColumn) {
+                edm::Exception exception(edm::errors::NotFound);
+                exception
+                    << "No trigger prescale column for HLT prescale set " << this->karmaEventHandle->triggerPrescaleSet
+                    << " in luminosity block " << event.luminosityBlock() << " of run " << event.run() << "!";
+                throw exception;
+            }
+            triggerPathHLTPrescales = &prescaleColumn->hltPrescales;
+            triggerPathL1Prescales = &prescaleColumn->l1Prescales;
+        }
     }
     // store trigger results as `dijet::TriggerBits`
     dijet::TriggerBits bitsetHLTBits;
@@ -394,8 +403,7 @@ void dijet::NtupleV2Producer::produce(edm::Event& event, const edm::EventSetup&
         if (idxInConfig >= 0) {
             // store prescale value
             if (globalCache()->doPrescales_) {
-                outputNtupleV2Entry->triggerPrescales[idxInConfig] = this->karmaEventHandle->triggerPathHLTPrescales[iBit] *
-                                                                     this->karmaEventHandle->triggerPathL1Prescales[iBit];
+                outputNtupleV2Entry->triggerPrescales[idxInConfig] = (*triggerPathHLTPrescales)[iBit] * (*triggerPathL1Prescales)[iBit];
             }
             // if trigger fired
             if (this->karmaEventHandle->hltBits[iBit]) {
@@ -491,8 +499,8 @@ void dijet::NtupleV2Producer::produce(edm::Event& event, const edm::EventSetup&
         outputNtupleV2Entry->Jet_NumNeutralParticles[iJet] = jet.nConstituents - jet.nCharged;
         */
         // factors used for individual JEC uncertainties
-        for (const auto& jesUncSrc : globalCache()->jesUncertaintySources_) {
-            outputNtupleV2Entry->Jet_jesUncertaintyFactors[iJet].push_back(jet.transientDoubles_.at(jesUncSrc));
+        for (const auto& jesUncSrcKey : globalCache()->jesUncertaintySourceKeys_) {
+            outputNtupleV2Entry->Jet_jesUncertaintyFactors[iJet].push_back(jet.transientDoubles_.at(jesUncSrcKey));
         };
 
         // matched genJet (MC-only)
@@ -504,8 +512,8 @@ void dijet::NtupleV2Producer::produce(edm::Event& event, const edm::EventSetup&
             outputNtupleV2Entry->Jet_hadronFlavor[iJet] = jet.hadronFlavor;
             // factors used for JER smearing
             try {
-                outputNtupleV2Entry->Jet_jerSmearingFactor[iJet] = jet.transientDoubles_.at("JERSmearingFactor");
-                outputNtupleV2Entry->Jet_jerScaleFactor[iJet] = jet.transientDoubles_.at("JERScaleFactor");
+                outputNtupleV2Entry->Jet_jerSmearingFactor[iJet] = jet.transientDoubles_.at(globalCache()->jerSmearingFactorKey_);
+                outputNtupleV2Entry->Jet_jerScaleFactor[iJet] = jet.transientDoubles_.at(globalCache()->jerScaleFactorKey_);
             }
             catch (const std::out_of_range& err) {
                 // factors not calculated (jets not being smeared) -> set to unity
@@ -819,28 +827,20 @@ dijet::TriggerBitsets dijet::NtupleV2Producer::getTriggerBitsetsForJetPair(unsig
                     if (jet1AssignedPathIdxInConfig < 0)
                         continue;
 
-                    for (const auto& jet2AssignedPathIdx : jet2MatchedTriggerObject->assignedPathIndices) {
-                        // get the index of trigger in analysis config
-                        const int jet2AssignedPathIdxInConfig = runCache()->triggerPathsIndicesInConfig_[jet2AssignedPathIdx];
-
-                        // skip unrequested trigger paths
-                        if (jet2AssignedPathIdxInConfig < 0)
-                            continue;
-
-                        // skip if objects not matched to the same trigger path
-                        if (jet1AssignedPathIdxInConfig != jet2AssignedPathIdxInConfig)
-                            continue;
+                    // skip if objects not matched to the same trigger path (single bit test;
+                    // the unversioned path names, and thus the indices in config, are unique in a menu)
+                    if (!jet2MatchedTriggerObject->isAssignedToPath(jet1AssignedPathIdx))
+                        continue;
 
-                        if ((jet1MatchedTriggerObject->isHLT()) && (jet2MatchedTriggerObject->isHLT())) {
-                            // both matches are HLT trigger objects
-                            triggerBitsets.hltMatches[jet1AssignedPathIdxInConfig] = true;
-                        }
-                        else if ((!jet1MatchedTriggerObject->isHLT()) && (!jet2MatchedTriggerObject->isHLT())) {
-                            // both matches are L1 trigger objects
-                            triggerBitsets.l1Matches[jet1AssignedPathIdxInConfig] = true;
-                        }
-                        // no else, since no pairs of trigger objects of "mixed" type
+                    if ((jet1MatchedTriggerObject->isHLT()) && (jet2MatchedTriggerObject->isHLT())) {
+                        // both matches are HLT trigger objects
+                        triggerBitsets.hltMatches[jet1AssignedPathIdxInConfig] = true;
+                    }
+                    else if ((!jet1MatchedTriggerObject->isHLT()) && (!jet2MatchedTriggerObject->isHLT())) {
+                        // both matches are L1 trigger objects
+                        triggerBitsets.l1Matches[jet1AssignedPathIdxInConfig] = true;
                     }
+                    // no else, since no pairs of trigger objects of "mixed" type
                 }
 
                 // set L1 and HLT emulation trigger bits if jets (jet pair) pass(es) preset thresholds
@@ -6,7 +6,7 @@ from collections import OrderedDict
 from copy import deepcopy
 
 
-__all__ = ['Quantity', 'apply_defines', 'apply_filters', 'define_quantities']
+__all__ = ['Quantity', 'apply_defines', 'apply_filters', 'define_quantities', 'declare_flexgrids']
 
 class Quantity(object):
 
@@ -101,6 +101,26 @@ def apply_defines(data_frame, defines):
     return _df
 
 
+def declare_flexgrids(flexgrids):
+    """Make FlexGrid binnings available in the ROOT interpreter.
+
+    `flexgrids` maps the name of a global C++ variable to the path of a FlexGrid
+    binary file (see `karmaFlexGridToBinary`). The file is memory-mapped into a
+    `karma::FlexGridTables` object, whose compiled lookups `findIndex` and
+    `findIndices` can then be used in expressions. Requires the directory
+    containing `Karma/` (e.g. `$CMSSW_BASE/src`) to be on the ROOT include path.
+    """
+    import ROOT  # do this here to avoid ROOT overriding standard Python behavior
+
+    if not ROOT.gInterpreter.Declare('#include "Karma/Common/interface/Providers/FlexGridTables.h"'):
+        raise RuntimeError("Could not include FlexGridTables.h in ROOT interpreter: check ROOT include paths!")
+
+    for _name, _file_path in flexgrids.iteritems():
+        print("[declare_flexgrids] Mapping FlexGrid '{}' from file: {}".format(_name, _file_path))
+        if not ROOT.gInterpreter.Declare('const karma::FlexGridTables {} = karma::FlexGridTables::mapFile("{}");'.format(_name, _file_path)):
+            raise RuntimeError("Could not declare FlexGrid '{}' in ROOT interpreter!".format(_name))
+
+
 def apply_filters(data_frame, filters):
     """Applies all 'Filters' specified in a list to an data frame."""
     _df = data_frame
@@ -129,6 +129,12 @@ class LumberjackInterfaceBase(object):
             print("[INFO] Executing ROOT_INIT_FUNC...")
             self._config.ROOT_INIT_FUNC()
 
+        # -- make FlexGrid binnings available in interpreter
+        if hasattr(self._config, 'FLEXGRIDS'):
+            from Karma.PostProcessing.Lumberjack import declare_flexgrids
+            print("[INFO] Declaring FlexGrid binnings...")
+            declare_flexgrids(self._config.FLEXGRIDS)
+
         # -- execute ROOT macro code in interpreter
         if hasattr(self._config, 'ROOT_MACROS'):
             print("[INFO] Defining ROOT macros...")
@@ -7,6 +7,7 @@
 // user include files
 #include "Karma/Skimming/interface/GenericAssociationProducer.h"
 #include "Karma/SkimmingFormats/interface/Defaults.h"  // for karma::LorentzVector
+#include "Karma/SkimmingFormats/interface/TransientMap.h"  // for karma::TransientKey
 #include "FWCore/Utilities/interface/EDMException.h"
 
 #include "DataFormats/Common/interface/AssociationVector.h"
@@ -32,19 +33,20 @@ namespace karma {
     template<typename TInputCollection, typename TValue, typename... ExtensionTypes>
     class AssociationVectorProducerBase : public GenericAssociationProducer<
         TInputCollection,
+        TValue,
         edm::AssociationVector<edm::RefProd<TInputCollection>, std::vector<TValue>>,
         ExtensionTypes...> {
 
       public:
         typedef typename edm::AssociationVector<edm::RefProd<TInputCollection>, std::vector<TValue>> TAssociation;
-        typedef typename GenericAssociationProducer<TInputCollection, TAssociation, ExtensionTypes...>::TInputSingle TInputSingle;
+        typedef typename GenericAssociationProducer<TInputCollection, TValue, TAssociation, ExtensionTypes...>::TInputSingle TInputSingle;
 
-        explicit AssociationVectorProducerBase(const edm::ParameterSet& pSet) :  GenericAssociationProducer<TInputCollection, TAssociation, ExtensionTypes...>(pSet) {};
+        explicit AssociationVectorProducerBase(const edm::ParameterSet& pSet) :  GenericAssociationProducer<TInputCollection, TValue, TAssociation, ExtensionTypes...>(pSet) {};
         ~AssociationVectorProducerBase() {};
 
         // -- pSet descriptions for CMSSW help info and validation
         static void fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
-            GenericAssociationProducer<TInputCollection, edm::ValueMap<TValue>, ExtensionTypes...>::fillDescriptions(descriptions);
+            GenericAssociationProducer<TInputCollection, TValue, TAssociation, ExtensionTypes...>::fillDescriptions(descriptions);
         };
 
         /**
@@ -52,52 +54,23 @@ namespace karma {
          * the output association object.
          *
          * Specialization for filling `edm::AssociationVectors`.
-         *
-         * Calls 'produceValue' for each object in the input collection
-         * to produce the associated value.
          */
         virtual std::unique_ptr<TAssociation> makeAssociation(
             const edm::Handle<TInputCollection>& referencedCollection,
-            const std::string& transientMapKey) {
+            const std::vector<TValue>& values) {
 
             // create output association vector
             std::unique_ptr<TAssociation> outputAssociation(new TAssociation(
                 edm::RefProd<TInputCollection>(referencedCollection)
             ));
 
-            // call produceSingle() for every element of the input collection
-            for (size_t i = 0; i < referencedCollection->size(); ++i) {
-                try {
-                    // call `produceValue()` to obtain the associated value
-                    (*outputAssociation)[edm::Ref<TInputCollection>(referencedCollection, i)] =
-                        this->produceValue(
-                            referencedCollection->at(i),
-                            // use <transientMapKey> spec parameter for lookup in original object
-                            transientMapKey
-                        );
-                }
-                catch (std::out_of_range& e) {
-                    edm::Exception exception(edm::errors::NotFound);
-                    exception << "Could not find value for key '" << transientMapKey << "' "
-                              << "in transient maps of product '"
-                              << referencedCollection.provenance()->branchName()
-                              <<  "', but it is needed to create the AssociationVector. Aborting!";
-                    throw exception;
-                }
+            for (size_t i = 0; i < values.size(); ++i) {
+                (*outputAssociation)[edm::Ref<TInputCollection>(referencedCollection, i)] = values[i];
             }
 
             return outputAssociation;
         };
 
-        /**
-         * Called by 'produce'. Returns the value associated to an
-         * object `in` in the input collection and a key in ?one of?
-         * the transient map contained in the data format.
-         *
-         * Should be implemented by all derived classes.
-         */
-        virtual TValue produceValue(const TInputSingle& in, const std::string& transientMapKey) = 0;
-
     };
 
 
@@ -115,11 +88,11 @@ namespace karma {
         // inherit all constructors from base class (only C++11)
         using AssociationVectorProducerBase<TInputCollection, bool, ExtensionTypes...>::AssociationVectorProducerBase;
 
-        virtual bool produceValue(
+        virtual const bool* findValue(
             const typename TInputCollection::value_type& in,
-            const std::string& transientMapKey) {
+            const karma::TransientKey& transientMapKey) {
 
-            return in.transientBools_.at(transientMapKey);
+            return in.transientBools_.get(transientMapKey);
         }
     };
 
@@ -130,11 +103,11 @@ namespace karma {
         // inherit all constructors from base class (only C++11)
         using AssociationVectorProducerBase<TInputCollection, int, ExtensionTypes...>::AssociationVectorProducerBase;
 
-        virtual int produceValue(
+        virtual const int* findValue(
             const typename TInputCollection::value_type& in,
-            const std::string& transientMapKey) {
+            const karma::TransientKey& transientMapKey) {
 
-            return in.transientInts_.at(transientMapKey);
+            return in.transientInts_.get(transientMapKey);
         }
     };
 
@@ -145,11 +118,11 @@ namespace karma {
         // inherit all constructors from base class (only C++11)
         using AssociationVectorProducerBase<TInputCollection, double, ExtensionTypes...>::AssociationVectorProducerBase;
 
-        virtual double produceValue(
+        virtual const double* findValue(
             const typename TInputCollection::value_type& in,
-            const std::string& transientMapKey) {
+            const karma::TransientKey& transientMapKey) {
 
-            return in.transientDoubles_.at(transientMapKey);
+            return in.transientDoubles_.get(transientMapKey);
         }
     };
 
@@ -160,11 +133,11 @@ namespace karma {
         // inherit all constructors from base class (only C++11)
         using AssociationVectorProducerBase<TInputCollection, karma::LorentzVector, ExtensionTypes...>::AssociationVectorProducerBase;
 
-        virtual karma::LorentzVector produceValue(
+        virtual const karma::LorentzVector* findValue(
             const typename TInputCollection::value_type& in,
-            const std::string& transientMapKey) {
+            const karma::TransientKey& transientMapKey) {
 
-            return in.transientLVs_.at(transientMapKey);
+            return in.transientLVs_.get(transientMapKey);
         }
     };
 
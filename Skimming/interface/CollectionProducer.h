@@ -1,7 +1,14 @@
 #pragma once
 
 // system include files
+#include <algorithm>
+#include <iterator>
 #include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
 
 // user include files
 #include "Karma/Common/interface/EDMTools/Util.h"
@@ -9,6 +16,7 @@
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "FWCore/Framework/interface/stream/EDProducer.h"
 #include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Utilities/interface/EDMException.h"
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
@@ -19,6 +27,32 @@
 //
 namespace karma {
 
+    // -- helpers
+
+    /**
+     * Type trait identifying output collections stored as a structure of
+     * arrays (e.g. `karma::JetSoACollection`). These declare a nested type
+     * `is_struct_of_arrays` and provide `push_back(const value_type&)` and
+     * `append(const TCollection&)`.
+     */
+    template<typename TCollection, typename = void>
+    struct IsStructOfArrays : std::false_type {};
+
+    template<typename TCollection>
+    struct IsStructOfArrays<TCollection, typename std::enable_if<TCollection::is_struct_of_arrays::value>::type> : std::true_type {};
+
+    /**
+     * Type trait identifying producers whose `acceptSingle()` and
+     * `produceSingle()` can be called concurrently for different input
+     * elements, i.e. which do not modify any member data in these methods.
+     * These declare a nested type `is_reentrant` (see `CollectionProducerBase`).
+     */
+    template<typename TProducer, typename = void>
+    struct IsReentrantProducer : std::false_type {};
+
+    template<typename TProducer>
+    struct IsReentrantProducer<TProducer, typename std::enable_if<TProducer::is_reentrant::value>::type> : std::true_type {};
+
     // -- main producer
 
     /**
@@ -31,6 +65,24 @@ namespace karma {
      *
      * Multithreading extensions can be used together with this template
      * by adding the respective template arguments after the first two.
+     *
+     * The output collection can also be a structure-of-arrays collection
+     * (see `IsStructOfArrays`). In that case, `produceSingle()` fills a
+     * temporary object of type `TOutputCollection::value_type`, which is
+     * then moved into the output collection.
+     *
+     * Producers for large collections should be declared `final` and
+     * override `produce()` to call `produceCollection(*this, ...)`, so that
+     * the per-element calls to `acceptSingle()` and `produceSingle()` can
+     * be devirtualized by the compiler.
+     *
+     * Producers declaring a nested type `typedef std::true_type is_reentrant`
+     * can optionally process large input collections in parallel: if the
+     * (optional) parameter `parallelMinInputSize` is set to a non-zero value,
+     * input collections with at least this number of elements are split into
+     * chunks of `parallelChunkSize` elements (default: 1024), which are
+     * processed concurrently using TBB. The output is identical to (and in
+     * the same order as) the serial case.
      */
     template<typename TInputCollection, typename TOutputCollection, typename... ExtensionTypes>
     class CollectionProducerBase : public edm::stream::EDProducer<ExtensionTypes...> {
@@ -45,6 +97,17 @@ namespace karma {
 
             // -- declare which collections are consumed and create tokens
             inputCollectionToken_ = this->template consumes<TInputCollection>(this->m_configPSet.template getParameter<edm::InputTag>("inputCollection"));
+
+            // -- optional: parallel processing of large input collections
+            if (this->m_configPSet.template existsAs<unsigned int>("parallelMinInputSize"))
+                m_parallelMinInputSize = this->m_configPSet.template getParameter<unsigned int>("parallelMinInputSize");
+            if (this->m_configPSet.template existsAs<unsigned int>("parallelChunkSize"))
+                m_parallelChunkSize = this->m_configPSet.template getParameter<unsigned int>("parallelChunkSize");
+            if (m_parallelChunkSize == 0) {
+                edm::Exception exception(edm::errors::Configuration);
+                exception << "Parameter 'parallelChunkSize' must be greater than zero!";
+                throw exception;
+            }
         };
         ~CollectionProducerBase() {};
 
@@ -61,32 +124,113 @@ namespace karma {
 
         // -- "regular" per-Event 'produce' method
         virtual void produce(edm::Event& event, const edm::EventSetup& setup) {
+            this->produceCollection(*this, event, setup);
+        };
+
+        virtual void produceSingle(const TInputSingle& in, TOutputSingle& out, const edm::Event&, const edm::EventSetup& setup) = 0;
+
+        inline virtual bool acceptSingle(const TInputSingle& in, const edm::Event&, const edm::EventSetup& setup) {
+            return true;  // accept all by default
+        }
+
+
+      protected:
+
+        /**
+         * Produce the output collection by calling `acceptSingle()` and
+         * `produceSingle()` on `producer` for every element of the input
+         * collection. If `TProducer` is a `final` class, these calls are
+         * resolved at compile time.
+         */
+        template<typename TProducer>
+        void produceCollection(TProducer& producer, edm::Event& event, const edm::EventSetup& setup) {
             karma::util::getByTokenOrThrow(event, this->inputCollectionToken_, this->inputCollectionHandle_);
+            const TInputCollection& inputCollection = *this->inputCollectionHandle_;
+
+            // create output collection (reserve for the case that all elements are accepted)
+            std::unique_ptr<TOutputCollection> outputCollection(new TOutputCollection());
+            outputCollection->reserve(inputCollection.size());
+
+            if ((m_parallelMinInputSize > 0) && (inputCollection.size() >= m_parallelMinInputSize)) {
+                fillCollectionParallel(producer, inputCollection, *outputCollection, event, setup, IsReentrantProducer<TProducer>());
+            }
+            else {
+                fillCollection(producer, inputCollection.begin(), inputCollection.end(), *outputCollection, event, setup);
+            }
 
-            // create output collection
-            std::unique_ptr<TOutputCollection> outputJetCollection(new TOutputCollection());
+            event.put(std::move(outputCollection));
+        };
+
+      private:
 
-            // call produceSingle() for every element of the input collection
-            for (size_t i = 0; i < this->inputCollectionHandle_->size(); ++i) {
+        // -- call produceSingle() for every element in the input range
+        template<typename TProducer, typename TInputIterator>
+        static void fillCollection(TProducer& producer, TInputIterator begin, TInputIterator end, TOutputCollection& outputCollection, const edm::Event& event, const edm::EventSetup& setup) {
+            for (auto it = begin; it != end; ++it) {
                 // skip elements rejected by `acceptSingle()`
-                if (!this->acceptSingle(this->inputCollectionHandle_->at(i), event, setup)) {
+                // (before an output slot is created for them)
+                if (!producer.acceptSingle(*it, event, setup)) {
                     continue;
                 }
-                // default-construct an output object in-place in the output collection
-                outputJetCollection->emplace_back();
-                // call `productSingle()` to fill the newly created output object
-                this->produceSingle(this->inputCollectionHandle_->at(i), outputJetCollection->back(), event, setup);
+                appendSingle(producer, *it, outputCollection, event, setup, IsStructOfArrays<TOutputCollection>());
+            }
+        };
+
+        // -- process chunks of the input collection concurrently (reentrant producers only)
+        template<typename TProducer>
+        void fillCollectionParallel(TProducer& producer, const TInputCollection& inputCollection, TOutputCollection& outputCollection, const edm::Event& event, const edm::EventSetup& setup, std::true_type) {
+            const size_t nInputs = inputCollection.size();
+            const size_t nChunks = (nInputs + m_parallelChunkSize - 1) / m_parallelChunkSize;
+
+            // one output buffer per chunk, concatenated in order afterwards
+            std::vector<TOutputCollection> chunkOutputCollections(nChunks);
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, nChunks), [&](const tbb::blocked_range<size_t>& chunkRange) {
+                for (size_t iChunk = chunkRange.begin(); iChunk != chunkRange.end(); ++iChunk) {
+                    const size_t iBegin = iChunk * m_parallelChunkSize;
+                    const size_t iEnd = std::min(iBegin + m_parallelChunkSize, nInputs);
+                    chunkOutputCollections[iChunk].reserve(iEnd - iBegin);
+                    fillCollection(producer, std::next(inputCollection.begin(), iBegin), std::next(inputCollection.begin(), iEnd), chunkOutputCollections[iChunk], event, setup);
+                }
+            });
+
+            for (auto& chunkOutputCollection : chunkOutputCollections) {
+                appendCollection(outputCollection, chunkOutputCollection, IsStructOfArrays<TOutputCollection>());
             }
+        };
 
-            event.put(std::move(outputJetCollection));
+        // -- producer not declared reentrant: parallel processing not possible
+        template<typename TProducer>
+        void fillCollectionParallel(TProducer& producer, const TInputCollection& inputCollection, TOutputCollection& outputCollection, const edm::Event& event, const edm::EventSetup& setup, std::false_type) {
+            edm::Exception exception(edm::errors::Configuration);
+            exception << "Parameter 'parallelMinInputSize' is set, but this producer does not support parallel processing "
+                      << "(`acceptSingle()`/`produceSingle()` not declared reentrant)!";
+            throw exception;
         };
 
-        virtual void produceSingle(const TInputSingle& in, TOutputSingle& out, const edm::Event&, const edm::EventSetup& setup) = 0;
+        // -- move the elements of a chunk to the end of the output collection
+        static void appendCollection(TOutputCollection& outputCollection, TOutputCollection& chunkOutputCollection, std::false_type) {
+            outputCollection.insert(outputCollection.end(), std::make_move_iterator(chunkOutputCollection.begin()), std::make_move_iterator(chunkOutputCollection.end()));
+        };
+        static void appendCollection(TOutputCollection& outputCollection, TOutputCollection& chunkOutputCollection, std::true_type) {
+            outputCollection.append(chunkOutputCollection);
+        };
 
-        inline virtual bool acceptSingle(const TInputSingle& in, const edm::Event&, const edm::EventSetup& setup) {
-            return true;  // accept all by default
-        }
+        // -- fill one output object in-place (array-of-structures output)
+        template<typename TProducer>
+        static void appendSingle(TProducer& producer, const TInputSingle& in, TOutputCollection& outputCollection, const edm::Event& event, const edm::EventSetup& setup, std::false_type) {
+            // default-construct an output object in-place in the output collection
+            outputCollection.emplace_back();
+            // call `productSingle()` to fill the newly created output object
+            producer.produceSingle(in, outputCollection.back(), event, setup);
+        };
 
+        // -- fill a temporary output object and move it in (structure-of-arrays output)
+        template<typename TProducer>
+        static void appendSingle(TProducer& producer, const TInputSingle& in, TOutputCollection& outputCollection, const edm::Event& event, const edm::EventSetup& setup, std::true_type) {
+            TOutputSingle outputSingle;
+            producer.produceSingle(in, outputSingle, event, setup);
+            outputCollection.push_back(std::move(outputSingle));
+        };
 
         // ----------member data ---------------------------
 
@@ -98,6 +242,10 @@ namespace karma {
         typename edm::Handle<TInputCollection> inputCollectionHandle_;
         edm::EDGetTokenT<TInputCollection> inputCollectionToken_;
 
+        // -- parallel processing of large input collections (see class description)
+        size_t m_parallelMinInputSize = 0;  // zero: disabled
+        size_t m_parallelChunkSize = 1024;
+
     };
 
     //
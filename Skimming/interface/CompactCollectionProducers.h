@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CollectionProducer.h"
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+
+// -- input/output data formats
+#include "Karma/SkimmingFormats/interface/Event.h"
+#include "Karma/SkimmingFormats/interface/CompactEvent.h"
+
+
+namespace karma {
+
+    /**
+     * Producer converting a collection of karma objects to the
+     * corresponding compact format (see `CompactEvent.h`) for writing
+     * out a reduced-size skim.
+     */
+    template<typename TInputCollection, typename TOutputCollection>
+    class ToCompactCollectionProducer final : public karma::CollectionProducerBase<TInputCollection, TOutputCollection> {
+
+      public:
+        typedef typename karma::CollectionProducerBase<TInputCollection, TOutputCollection>::TInputSingle TInputSingle;
+        typedef typename karma::CollectionProducerBase<TInputCollection, TOutputCollection>::TOutputSingle TOutputSingle;
+        typedef std::true_type is_reentrant;  // stateless conversion
+
+        explicit ToCompactCollectionProducer(const edm::ParameterSet& config) :
+            karma::CollectionProducerBase<TInputCollection, TOutputCollection>(config) {};
+        ~ToCompactCollectionProducer() {};
+
+        // call "parent" fill loop (devirtualized, since this class is final)
+        virtual void produce(edm::Event& event, const edm::EventSetup& setup) override {
+            this->produceCollection(*this, event, setup);
+        };
+
+        virtual void produceSingle(const TInputSingle& in, TOutputSingle& out, const edm::Event&, const edm::EventSetup&) {
+            karma::toCompact(in, out);
+        };
+
+    };
+
+    /**
+     * Producer converting a collection in a compact format (see
+     * `CompactEvent.h`) back to the corresponding collection of karma
+     * objects with double-precision members. Intended to be run directly
+     * after reading a compact skim, so that downstream producers are
+     * unaffected by the storage format.
+     */
+    template<typename TInputCollection, typename TOutputCollection>
+    class FromCompactCollectionProducer final : public karma::CollectionProducerBase<TInputCollection, TOutputCollection> {
+
+      public:
+        typedef typename karma::CollectionProducerBase<TInputCollection, TOutputCollection>::TInputSingle TInputSingle;
+        typedef typename karma::CollectionProducerBase<TInputCollection, TOutputCollection>::TOutputSingle TOutputSingle;
+        typedef std::true_type is_reentrant;  // stateless conversion
+
+        explicit FromCompactCollectionProducer(const edm::ParameterSet& config) :
+            karma::CollectionProducerBase<TInputCollection, TOutputCollection>(config) {};
+        ~FromCompactCollectionProducer() {};
+
+        // call "parent" fill loop (devirtualized, since this class is final)
+        virtual void produce(edm::Event& event, const edm::EventSetup& setup) override {
+            this->produceCollection(*this, event, setup);
+        };
+
+        virtual void produceSingle(const TInputSingle& in, TOutputSingle& out, const edm::Event&, const edm::EventSetup&) {
+            karma::fromCompact(in, out);
+        };
+
+    };
+
+    typedef typename karma::ToCompactCollectionProducer<karma::LVCollection, karma::CompactLVCollection> CompactLVCollectionProducer;
+    typedef typename karma::ToCompactCollectionProducer<karma::JetCollection, karma::CompactJetCollection> CompactJetCollectionProducer;
+
+    typedef typename karma::FromCompactCollectionProducer<karma::CompactLVCollection, karma::LVCollection> LVCollectionFromCompactProducer;
+    typedef typename karma::FromCompactCollectionProducer<karma::CompactJetCollection, karma::JetCollection> JetCollectionFromCompactProducer;
+
+}  // end namespace
@@ -1,15 +1,20 @@
 #pragma once
 
+#include <algorithm>
 #include <stdexcept>
+#include <utility>
 
 #include "CollectionProducer.h"
 
 #include "FWCore/Utilities/interface/EDMException.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
 
+#include "Karma/Common/interface/EDMTools/Caches.h"
+
 
 // -- output data formats
 #include "Karma/SkimmingFormats/interface/Event.h"
+#include "Karma/SkimmingFormats/interface/Run.h"
 
 // -- input data formats
 #include <DataFormats/PatCandidates/interface/Electron.h>
@@ -17,31 +22,122 @@
 
 namespace karma {
 
-    class ElectronCollectionProducer : public karma::CollectionProducerBase<edm::View<pat::Electron>, karma::ElectronCollection> {
+    /** Cache containing resources which do not change
+     *  for the entire duration of the skimming job.
+     */
+    class ElectronCollectionProducerGlobalCache : public karma::CacheBase {
 
       public:
-        explicit ElectronCollectionProducer(const edm::ParameterSet& config) :
-            karma::CollectionProducerBase<edm::View<pat::Electron>, karma::ElectronCollection>(config),
-            m_produceEcalTrkEnergyCorrections(this->m_configPSet.template getParameter<bool>("produceEcalTrkEnergyCorrections")) {
+        ElectronCollectionProducerGlobalCache(const edm::ParameterSet& pSet) :
+            karma::CacheBase(pSet) {
 
             // -- set up electron Ids
-            const auto& electronIdSpecs = this->m_configPSet.template getParameter<edm::VParameterSet>("electronIds");
+            const auto& electronIdSpecs = pSet_.getParameter<edm::VParameterSet>("electronIds");
             for (const auto& electronIdSpec : electronIdSpecs) {
-                m_electronIdSpecs[electronIdSpec.getParameter<std::string>("name")] =
-                    electronIdSpec.getParameter<std::vector<std::string>>("workingPoints");
+                electronIdSpecs_.idNames.emplace_back(electronIdSpec.getParameter<std::string>("name"));
+                electronIdSpecs_.workingPointNames.emplace_back(electronIdSpec.getParameter<std::vector<std::string>>("workingPoints"));
+                if (electronIdSpecs_.workingPointNames.back().size() > karma::Electron::MAX_WORKING_POINTS_PER_ID) {
+                    edm::Exception exception(edm::errors::Configuration);
+                    exception << "Too many working points configured for electron Id '" << electronIdSpecs_.idNames.back()
+                              << "': " << electronIdSpecs_.workingPointNames.back().size() << " > " << karma::Electron::MAX_WORKING_POINTS_PER_ID;
+                    throw exception;
+                }
+            }
+            if (electronIdSpecs_.idNames.size() > karma::Electron::MAX_IDS) {
+                edm::Exception exception(edm::errors::Configuration);
+                exception << "Too many electron Ids configured: " << electronIdSpecs_.idNames.size() << " > " << karma::Electron::MAX_IDS;
+                throw exception;
             }
+        };
+
+        // electron Id specification (names and working points, from loose to tight)
+        karma::ElectronIdSpecs electronIdSpecs_;
+
+    };
+
+    /**
+     * Producer of karma electrons from PAT electrons.
+     *
+     * The decisions of the configured electron ID working points are stored
+     * as a bit mask in `karma::Electron::idBits`. The working points are
+     * looked up in the electron ID list of the PAT electrons once per run
+     * (using the first electron seen in the run), so that no string
+     * comparisons are needed per electron.
+     *
+     * The names of the IDs and working points are written out once per run
+     * as a `karma::ElectronIdSpecs` product, so that the bit mask can be
+     * decoded from the skim alone.
+     */
+    class ElectronCollectionProducer final : public karma::CollectionProducerBase<
+        edm::View<pat::Electron>,
+        karma::ElectronCollection,
+        edm::GlobalCache<karma::ElectronCollectionProducerGlobalCache>,
+        edm::BeginRunProducer> {
+
+      public:
+        explicit ElectronCollectionProducer(const edm::ParameterSet& config, const karma::ElectronCollectionProducerGlobalCache* globalCache) :
+            karma::CollectionProducerBase<
+                edm::View<pat::Electron>,
+                karma::ElectronCollection,
+                edm::GlobalCache<karma::ElectronCollectionProducerGlobalCache>,
+                edm::BeginRunProducer>(config),
+            m_electronIdSpecs(globalCache->electronIdSpecs_),
+            m_produceEcalTrkEnergyCorrections(this->m_configPSet.template getParameter<bool>("produceEcalTrkEnergyCorrections")) {
 
+            // -- register run product with the electron Id names
+            this->template produces<karma::ElectronIdSpecs, edm::InRun>();
         };
         ~ElectronCollectionProducer() {};
 
-        //virtual void produce(edm::Event& event, const edm::EventSetup& setup) override;
+        // -- global cache extension
+        static std::unique_ptr<karma::ElectronCollectionProducerGlobalCache> initializeGlobalCache(const edm::ParameterSet& pSet) {
+            // -- create the GlobalCache
+            return std::unique_ptr<karma::ElectronCollectionProducerGlobalCache>(new karma::ElectronCollectionProducerGlobalCache(pSet));
+        };
+        static void globalEndJob(const karma::ElectronCollectionProducerGlobalCache*) {/* noop */};
+
+        // -- begin run producer extension: write out electron Id names
+        static void globalBeginRunProduce(edm::Run& run, const edm::EventSetup& setup, const RunContext* runContext) {
+            std::unique_ptr<karma::ElectronIdSpecs> electronIdSpecs(new karma::ElectronIdSpecs(runContext->global()->electronIdSpecs_));
+            run.put(std::move(electronIdSpecs));
+        };
+
+        // electron Ids are resolved again at the first event of each run
+        virtual void beginRun(const edm::Run& run, const edm::EventSetup& setup) override {
+            m_electronIdsResolved = false;
+        };
+
+        // need to override produce function to resolve the electron Ids
+        virtual void produce(edm::Event& event, const edm::EventSetup& setup) override {
+            if (!m_electronIdsResolved) {
+                karma::util::getByTokenOrThrow(event, this->inputCollectionToken_, this->inputCollectionHandle_);
+                if (!this->inputCollectionHandle_->empty()) {
+                    resolveElectronIds(this->inputCollectionHandle_->front());
+                }
+            }
+
+            // call "parent" fill loop (devirtualized, since this class is final)
+            this->produceCollection(*this, event, setup);
+        };
+
         virtual void produceSingle(const pat::Electron&, karma::Electron&, const edm::Event&, const edm::EventSetup&);
 
         inline virtual bool acceptSingle(const pat::Electron&, const edm::Event&, const edm::EventSetup&) override;
 
-    protected:
-        // store electron Id specification
-        std::map<std::string, std::vector<std::string>> m_electronIdSpecs;
+    private:
+        /**
+         * Check that all configured working points are available in `electron`
+         * and store their indices in `pat::Electron::electronIDs()` (called once per run)
+         */
+        void resolveElectronIds(const pat::Electron& electron);
+
+        // electron Id specification (names and working points, from loose to tight; owned by the global cache)
+        const karma::ElectronIdSpecs& m_electronIdSpecs;
+
+        // -- electron Ids (resolved at the first event of each run)
+        bool m_electronIdsResolved = false;
+        std::vector<std::vector<size_t>> m_electronIdIndices;  // index in `pat::Electron::electronIDs()` for each Id and working point
+        size_t m_numAvailableElectronIds = 0;
 
         // if true, fill electron energy correction variables (scale/smearing corrections)
         bool m_produceEcalTrkEnergyCorrections;
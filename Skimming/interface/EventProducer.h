@@ -2,9 +2,11 @@
 
 // system include files
 #include <memory>
+#include <mutex>
 
 // user include files
 #include "Karma/Common/interface/EDMTools/Util.h"
+#include "Karma/Common/interface/Tools/TriggerMenuRegistry.h"
 
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "FWCore/Framework/interface/stream/EDProducer.h"
@@ -13,7 +15,9 @@
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/Utilities/interface/StreamID.h"
-//#include "FWCore/Utilities/interface/Transition.h"  // CMSSW 9+
+#if CMSSW_MAJOR_VERSION > 8
+    #include "FWCore/Utilities/interface/Transition.h"  // CMSSW 9+
+#endif
 
 #include <boost/regex.hpp>
 #include <boost/bimap.hpp>
@@ -55,14 +59,14 @@ namespace karma {
             karma::CacheBase(pSet),
             isData_(pSet.getParameter<bool>("isData")),
             writeOutTriggerPrescales_(pSet.getParameter<bool>("writeOutTriggerPrescales")),
+            verifyCachedTriggerPrescales_(pSet.getParameter<bool>("verifyCachedTriggerPrescales")),
             hltProcessName_(pSet.getParameter<std::string>("hltProcessName")),
+            hltPathRegexes_(pSet.getParameter<std::vector<std::string>>("hltRegexes")),
             metFilterNames_(pSet.getParameter<std::vector<std::string>>("metFilterNames")) {
 
-            // create the regex objects for matching HLTtrigger names
-            const std::vector<std::string>& hltRegexes = pSet_.getParameter<std::vector<std::string>>("hltRegexes");
-            for (const auto& regexString : hltRegexes) {
+            // regexes for matching HLT trigger names are compiled by the `karma::TriggerMenuRegistry`
+            for (const auto& regexString : hltPathRegexes_) {
                 std::cout << "Adding HLT regex '" << regexString << "'" << std::endl;
-                hltPathRegexes_.push_back(boost::regex(regexString, boost::regex::icase | boost::regex::extended));
             }
 
             metFilterTriggerResultsProcessName_ = pSet.getParameter<edm::InputTag>("metFiltersSrc").process();
@@ -71,10 +75,11 @@ namespace karma {
 
         bool isData_;
         bool writeOutTriggerPrescales_;  // if True, skims will contain trigger path prescales (only if they are non-ambiguous)
+        bool verifyCachedTriggerPrescales_;  // if True, check the prescales cached per lumi section against the per-event prescales
         std::string hltProcessName_;  // name of the process that produced the trigger path information
         std::string metFilterTriggerResultsProcessName_;  // name of the process that produced the MET filter bits
 
-        std::vector<boost::regex> hltPathRegexes_;  // list of pre-compiled regular expressions that 'interesting' trigger paths are required to match
+        std::vector<std::string> hltPathRegexes_;  // list of regular expressions that 'interesting' trigger paths are required to match
         std::vector<std::string> metFilterNames_;  // list of MET filter names that should be written out
 
         // helper objects to obtain metadata from TriggerResults products (default-constructed)
@@ -90,8 +95,10 @@ namespace karma {
       public:
         LumiCache(const edm::ParameterSet& pSet) : karma::CacheBase(pSet) {};
 
-        std::vector<int> hltPathHLTPrescales_;
-        std::vector<int> hltPathL1Prescales_;
+        // lumi product, written out at the end of the luminosity block
+        // (the prescale table is filled by all streams while processing events)
+        mutable karma::Lumi karmaLumi_;
+        mutable std::mutex karmaLumiMutex_;
 
     };
 
@@ -117,7 +124,7 @@ namespace karma {
         edm::GlobalCache<karma::GlobalCache>,
         edm::RunCache<karma::RunCache>,
         edm::LuminosityBlockCache<karma::LumiCache>,
-        edm::BeginLuminosityBlockProducer,
+        edm::EndLuminosityBlockProducer,
         edm::BeginRunProducer> {
 
       public:
@@ -141,24 +148,38 @@ namespace karma {
         static void globalEndLuminosityBlock(const edm::LuminosityBlock&, const edm::EventSetup&, const LuminosityBlockContext*) {/* noop */};
 
 
-        // -- begin lumi producer extension
-        static void globalBeginLuminosityBlockProduce(edm::LuminosityBlock&, const edm::EventSetup&, const LuminosityBlockContext*);
+        // -- end lumi producer extension
+        static void globalEndLuminosityBlockProduce(edm::LuminosityBlock&, const edm::EventSetup&, const LuminosityBlockContext*);
 
         // -- begin run producer extension
         static void globalBeginRunProduce(edm::Run&, const edm::EventSetup&, const RunContext*);
 
+        // -- stream transitions
+        virtual void beginRun(const edm::Run&, const edm::EventSetup&);
+        virtual void beginLuminosityBlock(const edm::LuminosityBlock&, const edm::EventSetup&);
+
         // -- "regular" per-Event 'produce' method
         virtual void produce(edm::Event&, const edm::EventSetup&);
 
 
       private:
 
+        // retrieve the prescales of the selected trigger paths for the current event
+        karma::TriggerPrescaleColumn getTriggerPrescaleColumn(const edm::Event&, const edm::EventSetup&);
+
         // ----------member data ---------------------------
 
         const edm::ParameterSet& m_configPSet;
 
         std::unique_ptr<HLTPrescaleProvider> m_hltPrescaleProvider;
 
+        // HLT prescale set index, i.e. the key of the prescale column in the per-lumi
+        // table (computed on the first event in each luminosity block seen by this stream)
+        int m_triggerPrescaleSet = -1;
+
+        // true if the missing HLT prescale set has already been reported (once per run and stream)
+        bool m_warnedUnknownTriggerPrescaleSet = false;
+
         // -- handles and tokens
         typename edm::Handle<edm::View<pat::Jet>> jetCollectionHandle;
         edm::EDGetTokenT<edm::View<pat::Jet>> jetCollectionToken;
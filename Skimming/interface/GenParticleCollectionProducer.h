@@ -14,9 +14,12 @@
 
 namespace karma {
 
-    class GenParticleCollectionProducer : public karma::CollectionProducerBase<edm::View<reco::GenParticle>, karma::GenParticleCollection> {
+    class GenParticleCollectionProducer final : public karma::CollectionProducerBase<edm::View<reco::GenParticle>, karma::GenParticleCollection> {
 
       public:
+        // `acceptSingle()` and `produceSingle()` only read member data
+        typedef std::true_type is_reentrant;
+
         explicit GenParticleCollectionProducer(const edm::ParameterSet& config) :
             karma::CollectionProducerBase<edm::View<reco::GenParticle>, karma::GenParticleCollection>(config) {
                 const auto& paramAllowedPDGIds = config.getParameter<std::vector<int>>("allowedPDGIds");
@@ -24,6 +27,11 @@ namespace karma {
         };
         ~GenParticleCollectionProducer() {};
 
+        // large input collection: use devirtualized fill loop
+        virtual void produce(edm::Event& event, const edm::EventSetup& setup) override {
+            this->produceCollection(*this, event, setup);
+        };
+
         virtual void produceSingle(const reco::GenParticle&, karma::GenParticle&, const edm::Event&, const edm::EventSetup&);
 
         inline virtual bool acceptSingle(const reco::GenParticle&, const edm::Event&, const edm::EventSetup&) override;
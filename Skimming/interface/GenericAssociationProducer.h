@@ -3,10 +3,13 @@
 // system include files
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 // user include files
 #include "Karma/Common/interface/EDMTools/Util.h"
 #include "Karma/SkimmingFormats/interface/Defaults.h"  // for karma::LorentzVector
+#include "Karma/SkimmingFormats/interface/TransientMap.h"  // for karma::TransientKey
 #include "FWCore/Utilities/interface/EDMException.h"
 
 #include "DataFormats/Common/interface/ValueMap.h"
@@ -24,6 +27,40 @@
 //
 namespace karma {
 
+    // -- helpers
+
+    /**
+     * Read the (optional) parameter `defaultValue` of an association spec.
+     * Returns false if the parameter is not present.
+     */
+    template<typename TValue>
+    struct AssociationDefaultValue {
+        static bool read(const edm::ParameterSet& associationSpec, TValue& defaultValue) {
+            if (!associationSpec.existsAs<TValue>("defaultValue"))
+                return false;
+            defaultValue = associationSpec.getParameter<TValue>("defaultValue");
+            return true;
+        };
+    };
+
+    // Lorentz vectors are specified as (pt, eta, phi, mass)
+    template<>
+    struct AssociationDefaultValue<karma::LorentzVector> {
+        static bool read(const edm::ParameterSet& associationSpec, karma::LorentzVector& defaultValue) {
+            if (!associationSpec.existsAs<std::vector<double>>("defaultValue"))
+                return false;
+            const auto& components = associationSpec.getParameter<std::vector<double>>("defaultValue");
+            if (components.size() != 4) {
+                edm::Exception exception(edm::errors::Configuration);
+                exception << "Parameter 'defaultValue' of association spec '" << associationSpec.getParameter<std::string>("name") << "' "
+                          << "must contain four values (pt, eta, phi, mass), got " << components.size() << "!";
+                throw exception;
+            }
+            defaultValue = karma::LorentzVector(components[0], components[1], components[2], components[3]);
+            return true;
+        };
+    };
+
     // -- base producer class
 
     /**
@@ -33,16 +70,20 @@ namespace karma {
      *
      * This producer reads an collection of Karma objects (of type
      * TInputCollection) and fills one or more Association objects
-     * (of type TAssociation) from the transient map stored for each
-     * object in the collection.
+     * (of type TAssociation, with values of type TValue) from the
+     * transient map stored for each object in the collection.
      *
      * The transient maps (part of the data formats) must be filled by
-     * another producer beforehand.
+     * another producer beforehand. The values for all association specs
+     * are obtained in a single pass over the input collection, filling
+     * one column of values per spec. If a key is not present in the
+     * transient map of an object, the optional `defaultValue` of the spec
+     * is used. If no default value is configured, an exception is thrown.
      *
      * Multithreading extensions can be used together with this template
-     * by adding the respective template arguments after the first two.
+     * by adding the respective template arguments after the first three.
      */
-    template<typename TInputCollection, typename TAssociation, typename... ExtensionTypes>
+    template<typename TInputCollection, typename TValue, typename TAssociation, typename... ExtensionTypes>
     class GenericAssociationProducer : public edm::stream::EDProducer<ExtensionTypes...> {
 
       public:
@@ -56,7 +97,12 @@ namespace karma {
                 const auto& associationSpec = associationSpecs[iSpec];
 
                 this->template produces<TAssociation>(associationSpec.getParameter<std::string>("name"));
-                m_mapNameToTransientKey[associationSpec.getParameter<std::string>("name")] = associationSpec.getParameter<std::string>("transientMapKey");
+
+                // keys resolved once at construction
+                m_associationSpecs.emplace_back();
+                m_associationSpecs.back().name = associationSpec.getParameter<std::string>("name");
+                m_associationSpecs.back().transientMapKey = karma::TransientKey(associationSpec.getParameter<std::string>("transientMapKey"));
+                m_associationSpecs.back().hasDefaultValue = karma::AssociationDefaultValue<TValue>::read(associationSpec, m_associationSpecs.back().defaultValue);
             }
 
             // -- declare which collections are consumed and create tokens
@@ -78,34 +124,77 @@ namespace karma {
         // -- "regular" per-Event 'produce' method
         void produce(edm::Event& event, const edm::EventSetup& setup) {
             karma::util::getByTokenOrThrow(event, this->inputCollectionToken_, this->inputCollectionHandle_);
+            const TInputCollection& inputCollection = *this->inputCollectionHandle_;
+
+            // one column of values per association spec
+            std::vector<std::vector<TValue>> valueColumns(m_associationSpecs.size(), std::vector<TValue>(inputCollection.size()));
+
+            // single pass over the input collection, filling all columns
+            for (size_t i = 0; i < inputCollection.size(); ++i) {
+                for (size_t iSpec = 0; iSpec < m_associationSpecs.size(); ++iSpec) {
+                    const auto& associationSpec = m_associationSpecs[iSpec];
+
+                    // use <transientMapKey> spec parameter for lookup in original object
+                    const TValue* value = this->findValue(inputCollection[i], associationSpec.transientMapKey);
+                    if (value) {
+                        valueColumns[iSpec][i] = *value;
+                    }
+                    else if (associationSpec.hasDefaultValue) {
+                        valueColumns[iSpec][i] = associationSpec.defaultValue;
+                    }
+                    else {
+                        edm::Exception exception(edm::errors::NotFound);
+                        exception << "Could not find value for key '" << associationSpec.transientMapKey.name() << "' "
+                                  << "in transient maps of product '"
+                                  << this->inputCollectionHandle_.provenance()->branchName()
+                                  <<  "', but it is needed to create the association '" << associationSpec.name << "' "
+                                  << "and no 'defaultValue' is configured. Aborting!";
+                        throw exception;
+                    }
+                }
+            }
 
-            for (const auto& mapNameAndTransientKey : m_mapNameToTransientKey) {
-
-                std::unique_ptr<TAssociation> outputAssociation = std::move(
-                    this->makeAssociation(this->inputCollectionHandle_, mapNameAndTransientKey.second)
-                );
+            for (size_t iSpec = 0; iSpec < m_associationSpecs.size(); ++iSpec) {
+                std::unique_ptr<TAssociation> outputAssociation = this->makeAssociation(this->inputCollectionHandle_, valueColumns[iSpec]);
 
-                // store the value map under <mapName> spec parameter
-                event.put(std::move(outputAssociation), mapNameAndTransientKey.first);
+                // store the association under <name> spec parameter
+                event.put(std::move(outputAssociation), m_associationSpecs[iSpec].name);
             }
         };
 
+        /**
+         * Called by 'produce'. Returns a pointer to the value stored for
+         * `transientMapKey` in ?one of? the transient maps contained in
+         * the data format, or `nullptr` if no value is stored for this key.
+         *
+         * Must be implemented by derived classes.
+         */
+        virtual const TValue* findValue(const TInputSingle& in, const karma::TransientKey& transientMapKey) = 0;
+
         /**
          * Called by 'produce'. Contains the implementation to create
-         * and fill the output association object.
+         * the output association object and fill it with `values`
+         * (one value per object in `referencedCollection`).
          *
          * Must be implemented by derived classes.
          */
         virtual std::unique_ptr<TAssociation> makeAssociation(
             const edm::Handle<TInputCollection>& referencedCollection,
-            const std::string& transientMapKey) = 0;
+            const std::vector<TValue>& values) = 0;
 
         // ----------member data ---------------------------
 
       protected:
 
+        struct AssociationSpec {
+            std::string name;
+            karma::TransientKey transientMapKey;
+            bool hasDefaultValue = false;
+            TValue defaultValue = TValue();
+        };
+
         const edm::ParameterSet& m_configPSet;
-        std::map<std::string, std::string> m_mapNameToTransientKey;
+        std::vector<AssociationSpec> m_associationSpecs;
 
       private:
         // -- handles and tokens
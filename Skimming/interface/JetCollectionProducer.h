@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+
 #include "CollectionProducer.h"
 
 #include "FWCore/Framework/interface/MakerMacros.h"
@@ -7,6 +9,8 @@
 
 // -- output data formats
 #include "Karma/SkimmingFormats/interface/Event.h"
+#include "Karma/SkimmingFormats/interface/JetSoA.h"
+#include "Karma/SkimmingFormats/interface/TransientMap.h"
 
 // -- input data formats
 #include "DataFormats/PatCandidates/interface/Jet.h"
@@ -14,39 +18,101 @@
 
 namespace karma {
 
-    class JetCollectionProducer : public karma::CollectionProducerBase<edm::View<pat::Jet>, karma::JetCollection> {
+    /**
+     * Producer of karma jets from PAT jets. The output collection can be a
+     * regular `karma::JetCollection` or a structure-of-arrays collection
+     * (`karma::JetSoACollection`).
+     *
+     * The JEC levels available in the input jets are resolved once per run
+     * (from the first jet seen in the run) to their level indices and
+     * transient map keys, so that no strings need to be constructed or
+     * compared in the per-jet loop. If `validateResolvedJECLevels` is set,
+     * the output is checked for each jet against a direct lookup by name.
+     */
+    template<typename TOutputCollection>
+    class GenericJetCollectionProducer final : public karma::CollectionProducerBase<edm::View<pat::Jet>, TOutputCollection> {
 
       public:
-        explicit JetCollectionProducer(const edm::ParameterSet& config) :
-            karma::CollectionProducerBase<edm::View<pat::Jet>, karma::JetCollection>(config) {
+        explicit GenericJetCollectionProducer(const edm::ParameterSet& config) :
+            karma::CollectionProducerBase<edm::View<pat::Jet>, TOutputCollection>(config),
+            m_validateResolvedJECLevels(this->m_configPSet.template getParameter<bool>("validateResolvedJECLevels")) {
 
-            // -- declare which collections are consumed and create tokens
+            // -- resolve transient map keys for user data
             const auto& transientInfoSpec =
-                this->m_configPSet.getParameter<edm::ParameterSet>("transientInformationSpec");
+                this->m_configPSet.template getParameter<edm::ParameterSet>("transientInformationSpec");
 
-            const auto& fromUserIntSpec = transientInfoSpec.getParameter<edm::ParameterSet>("fromUserInt");
+            const auto& fromUserIntSpec = transientInfoSpec.template getParameter<edm::ParameterSet>("fromUserInt");
             for(const auto& transientKeyName : fromUserIntSpec.getParameterNames()) {
-                m_transientIntKeyForUserInt[fromUserIntSpec.getParameter<std::string>(transientKeyName)] = transientKeyName;
+                m_transientIntKeyForUserInt.emplace_back(fromUserIntSpec.template getParameter<std::string>(transientKeyName), karma::TransientKey(transientKeyName));
             };
-            const auto& fromUserIntAsBoolSpec = transientInfoSpec.getParameter<edm::ParameterSet>("fromUserIntAsBool");
+            const auto& fromUserIntAsBoolSpec = transientInfoSpec.template getParameter<edm::ParameterSet>("fromUserIntAsBool");
             for(const auto& transientKeyName : fromUserIntAsBoolSpec.getParameterNames()) {
-                m_transientBoolKeyForUserInt[fromUserIntAsBoolSpec.getParameter<std::string>(transientKeyName)] = transientKeyName;
+                m_transientBoolKeyForUserInt.emplace_back(fromUserIntAsBoolSpec.template getParameter<std::string>(transientKeyName), karma::TransientKey(transientKeyName));
             };
-            const auto& fromUserFloatSpec = transientInfoSpec.getParameter<edm::ParameterSet>("fromUserFloat");
+            const auto& fromUserFloatSpec = transientInfoSpec.template getParameter<edm::ParameterSet>("fromUserFloat");
             for(const auto& transientKeyName : fromUserFloatSpec.getParameterNames()) {
-                m_transientDoubleKeyForUserFloat[fromUserFloatSpec.getParameter<std::string>(transientKeyName)] = transientKeyName;
+                m_transientDoubleKeyForUserFloat.emplace_back(fromUserFloatSpec.template getParameter<std::string>(transientKeyName), karma::TransientKey(transientKeyName));
             };
 
+            // fill transient maps in key order (entries are appended at the end)
+            for (auto* userVarNamesAndTransientKeys : {&m_transientBoolKeyForUserInt, &m_transientIntKeyForUserInt, &m_transientDoubleKeyForUserFloat}) {
+                std::sort(
+                    userVarNamesAndTransientKeys->begin(), userVarNamesAndTransientKeys->end(),
+                    [](const UserVarNameAndTransientKey& a, const UserVarNameAndTransientKey& b) { return a.second.id() < b.second.id(); }
+                );
+            }
+
+        };
+        ~GenericJetCollectionProducer() {};
+
+        // JEC levels are resolved again at the first event of each run
+        virtual void beginRun(const edm::Run& run, const edm::EventSetup& setup) override {
+            m_jecLevelsResolved = false;
+        };
+
+        // need to override produce function to resolve the JEC levels
+        virtual void produce(edm::Event& event, const edm::EventSetup& setup) override {
+            if (!m_jecLevelsResolved) {
+                karma::util::getByTokenOrThrow(event, this->inputCollectionToken_, this->inputCollectionHandle_);
+                if (!this->inputCollectionHandle_->empty()) {
+                    resolveJECLevels(this->inputCollectionHandle_->front());
+                }
+            }
+
+            // call "parent" fill loop (devirtualized, since this class is final)
+            this->produceCollection(*this, event, setup);
         };
-        ~JetCollectionProducer() {};
 
         virtual void produceSingle(const pat::Jet&, karma::Jet&, const edm::Event&, const edm::EventSetup&);
 
       private:
-        std::map<std::string,std::string> m_transientBoolKeyForUserInt;
-        std::map<std::string,std::string> m_transientIntKeyForUserInt;
-        std::map<std::string,std::string> m_transientDoubleKeyForUserFloat;
+        typedef std::pair<std::string, karma::TransientKey> UserVarNameAndTransientKey;
+
+        struct ResolvedJECLevel {
+            unsigned int levelIndex;  // index in `pat::Jet::availableJECLevels()`
+            karma::TransientKey transientKey;
+        };
+
+        /** Resolve the JEC levels available in `jet` (called once per run) */
+        void resolveJECLevels(const pat::Jet& jet);
+
+        /** Check the JEC levels and user data in `out` against a lookup by name (validation mode) */
+        void validateSingle(const pat::Jet& in, const karma::Jet& out, const edm::Event& event) const;
+
+        std::vector<UserVarNameAndTransientKey> m_transientBoolKeyForUserInt;
+        std::vector<UserVarNameAndTransientKey> m_transientIntKeyForUserInt;
+        std::vector<UserVarNameAndTransientKey> m_transientDoubleKeyForUserFloat;
+
+        // -- JEC levels (resolved at the first event of each run)
+        bool m_jecLevelsResolved = false;
+        std::vector<ResolvedJECLevel> m_jecLevels;  // sorted by transient key id
+        int m_jecLevelIndexUncorrected = -1;
+
+        bool m_validateResolvedJECLevels;  // if True, check the output against lookups by name for each jet
 
     };
 
+    typedef typename karma::GenericJetCollectionProducer<karma::JetCollection> JetCollectionProducer;
+    typedef typename karma::GenericJetCollectionProducer<karma::JetSoACollection> JetSoACollectionProducer;
+
 }  // end namespace
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unordered_map>
+
 #include "CollectionProducer.h"
 
 #include "FWCore/Framework/interface/MakerMacros.h"
@@ -13,12 +15,14 @@
 
 namespace karma {
 
-    class TriggerObjectCollectionProducer :
+    class TriggerObjectCollectionProducer final :
         public karma::CollectionProducerBase<
             /* TInputType =*/ pat::TriggerObjectStandAloneCollection,
             /* TOutputType =*/ karma::TriggerObjectCollection> {
 
       public:
+        typedef std::true_type is_reentrant;  // path assignments are computed in `produce()`
+
         explicit TriggerObjectCollectionProducer(const edm::ParameterSet& config) :
             karma::CollectionProducerBase<pat::TriggerObjectStandAloneCollection, karma::TriggerObjectCollection>(config) {
 
@@ -34,17 +38,12 @@ namespace karma {
         ~TriggerObjectCollectionProducer() {};
 
 
-        // need to override produce function to update karmaRun handle
-        virtual void produce(edm::Event& event, const edm::EventSetup& setup) {
-            // get additional event/run data
-            bool obtained = true;
-            obtained &= event.getRun().getByToken(this->karmaRunToken_, this->karmaRunHandle_);  // can this be optimized?
-            karma::util::getByTokenOrThrow(event, this->triggerResultsToken_, this->triggerResultsHandle_);
-            assert(obtained);
+        // resolve the selected trigger path names once per run
+        virtual void beginRun(const edm::Run& run, const edm::EventSetup& setup) override;
 
-            // call "parent" produce function
-            karma::CollectionProducerBase<pat::TriggerObjectStandAloneCollection, karma::TriggerObjectCollection>::produce(event, setup);
-        };
+        // need to override produce function to assign the trigger paths
+        // to the input objects before the fill loop
+        virtual void produce(edm::Event& event, const edm::EventSetup& setup) override;
 
         virtual void produceSingle(const pat::TriggerObjectStandAlone&, karma::TriggerObject&, const edm::Event&, const edm::EventSetup&);
 
@@ -63,29 +62,30 @@ namespace karma {
             //
             // if (!typeAccepted) return false;
 
-            // -- check trigger object path names
-
-            // need to unpack beforehand
-            const_cast<pat::TriggerObjectStandAlone&>(in).unpackPathNames(event.triggerNames(*this->triggerResultsHandle_));
+            // -- accept only objects assigned to at least one selected path
+            return !this->assignedPathIndices(in).empty();
+        };
 
-            bool pathAccepted = false;
-            for (const auto& triggeredPathName : in.pathNames()) {
-                for (const auto& pathInfo : this->karmaRunHandle_->triggerPathInfos) {
-                    if (pathInfo.name_ == triggeredPathName) {
-                        pathAccepted = true;
-                        break;
-                    }
-                }
-                if (pathAccepted) break;
-            }
+      private:
+        /**
+         * Return the indices of the selected paths the input object `in`
+         * is assigned to (computed in `produce()` for the current event).
+         */
+        inline const std::vector<int>& assignedPathIndices(const pat::TriggerObjectStandAlone& in) const {
+            return assignedPathIndicesPerObject_[&in - this->inputCollectionHandle_->data()];
+        };
 
-            if (!pathAccepted) return false;
+        // -- selected trigger path indices by path name (resolved once per run)
+        std::unordered_map<std::string, int> selectedPathIndicesByName_;
 
-            return true;  // accept all not explicitly rejected
+        // -- indices of the selected paths assigned to each input object
+        //    (filled in `produce()`, read-only in `acceptSingle()`/`produceSingle()`)
+        std::vector<std::vector<int>> assignedPathIndicesPerObject_;
 
-        };
+        // -- scratch copy of the input object whose path names are being unpacked
+        //    (only used in `produce()`)
+        pat::TriggerObjectStandAlone unpackedObject_;
 
-      private:
         // -- extra handle and token for karmaRun
         typename edm::Handle<karma::Run> karmaRunHandle_;
         edm::EDGetTokenT<karma::Run> karmaRunToken_;
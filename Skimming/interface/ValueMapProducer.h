@@ -7,6 +7,7 @@
 // user include files
 #include "Karma/Skimming/interface/GenericAssociationProducer.h"
 #include "Karma/SkimmingFormats/interface/Defaults.h"  // for karma::LorentzVector
+#include "Karma/SkimmingFormats/interface/TransientMap.h"  // for karma::TransientKey
 #include "FWCore/Utilities/interface/EDMException.h"
 
 #include "DataFormats/Common/interface/ValueMap.h"
@@ -32,19 +33,20 @@ namespace karma {
     template<typename TInputCollection, typename TValue, typename... ExtensionTypes>
     class ValueMapProducerBase : public GenericAssociationProducer<
         TInputCollection,
+        TValue,
         edm::ValueMap<TValue>,
         ExtensionTypes...> {
 
       public:
         typedef typename edm::ValueMap<TValue> TAssociation;
-        typedef typename GenericAssociationProducer<TInputCollection, TAssociation, ExtensionTypes...>::TInputSingle TInputSingle;
+        typedef typename GenericAssociationProducer<TInputCollection, TValue, TAssociation, ExtensionTypes...>::TInputSingle TInputSingle;
 
-        explicit ValueMapProducerBase(const edm::ParameterSet& pSet) :  GenericAssociationProducer<TInputCollection, TAssociation, ExtensionTypes...>(pSet) {};
+        explicit ValueMapProducerBase(const edm::ParameterSet& pSet) :  GenericAssociationProducer<TInputCollection, TValue, TAssociation, ExtensionTypes...>(pSet) {};
         ~ValueMapProducerBase() {};
 
         // -- pSet descriptions for CMSSW help info and validation
         static void fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
-            GenericAssociationProducer<TInputCollection, edm::ValueMap<TValue>, ExtensionTypes...>::fillDescriptions(descriptions);
+            GenericAssociationProducer<TInputCollection, TValue, TAssociation, ExtensionTypes...>::fillDescriptions(descriptions);
         };
 
         /**
@@ -52,55 +54,21 @@ namespace karma {
          * the output association object.
          *
          * Specialization for filling `edm::ValueMaps`.
-         *
-         * Calls 'produceValue' for each object in the input collection
-         * to produce the associated value.
          */
         virtual std::unique_ptr<TAssociation> makeAssociation(
             const edm::Handle<TInputCollection>& referencedCollection,
-            const std::string& transientMapKey) {
+            const std::vector<TValue>& values) {
 
             // create output value map
             std::unique_ptr<TAssociation> outputAssociation(new TAssociation());
 
             typename TAssociation::Filler filler(*outputAssociation);
-            std::vector<TValue> values(referencedCollection->size());
-            
-            // call produceSingle() for every element of the input collection
-            for (size_t i = 0; i < referencedCollection->size(); ++i) {
-                try {
-                    // call `produceValue()` to obtain the associated value
-                    values[i] = this->produceValue(
-                        referencedCollection->at(i),
-                        // use <transientMapKey> spec parameter for lookup in original object
-                        transientMapKey
-                    );
-                }
-                catch (std::out_of_range& e) {
-                    edm::Exception exception(edm::errors::NotFound);
-                    exception << "Could not find value for key '" << transientMapKey << "' "
-                              << "in transient maps of product '"
-                              << referencedCollection.provenance()->branchName()
-                              <<  "', but it is needed to create the ValueMap. Aborting!";
-                    throw exception;
-                }
-            }
-            
             filler.insert(referencedCollection, values.begin(), values.end());
             filler.fill();
 
             return outputAssociation;
         };
 
-        /**
-         * Called by 'produce'. Returns the value associated to an
-         * object `in` in the input collection and a key in ?one of?
-         * the transient map contained in the data format.
-         *
-         * Should be implemented by all derived classes.
-         */
-        virtual TValue produceValue(const TInputSingle& in, const std::string& transientMapKey) = 0;
-
     };
 
 
@@ -118,11 +86,11 @@ namespace karma {
         // inherit all constructors from base class (only C++11)
         using ValueMapProducerBase<TInputCollection, bool, ExtensionTypes...>::ValueMapProducerBase;
 
-        virtual bool produceValue(
+        virtual const bool* findValue(
             const typename TInputCollection::value_type& in,
-            const std::string& transientMapKey) {
+            const karma::TransientKey& transientMapKey) {
 
-            return in.transientBools_.at(transientMapKey);
+            return in.transientBools_.get(transientMapKey);
         }
     };
 
@@ -133,11 +101,11 @@ namespace karma {
         // inherit all constructors from base class (only C++11)
         using ValueMapProducerBase<TInputCollection, int, ExtensionTypes...>::ValueMapProducerBase;
 
-        virtual int produceValue(
+        virtual const int* findValue(
             const typename TInputCollection::value_type& in,
-            const std::string& transientMapKey) {
+            const karma::TransientKey& transientMapKey) {
 
-            return in.transientInts_.at(transientMapKey);
+            return in.transientInts_.get(transientMapKey);
         }
     };
 
@@ -148,11 +116,11 @@ namespace karma {
         // inherit all constructors from base class (only C++11)
         using ValueMapProducerBase<TInputCollection, double, ExtensionTypes...>::ValueMapProducerBase;
 
-        virtual double produceValue(
+        virtual const double* findValue(
             const typename TInputCollection::value_type& in,
-            const std::string& transientMapKey) {
+            const karma::TransientKey& transientMapKey) {
 
-            return in.transientDoubles_.at(transientMapKey);
+            return in.transientDoubles_.get(transientMapKey);
         }
     };
 
@@ -163,11 +131,11 @@ namespace karma {
         // inherit all constructors from base class (only C++11)
         using ValueMapProducerBase<TInputCollection, karma::LorentzVector, ExtensionTypes...>::ValueMapProducerBase;
 
-        virtual karma::LorentzVector produceValue(
+        virtual const karma::LorentzVector* findValue(
             const typename TInputCollection::value_type& in,
-            const std::string& transientMapKey) {
+            const karma::TransientKey& transientMapKey) {
 
-            return in.transientLVs_.at(transientMapKey);
+            return in.transientLVs_.get(transientMapKey);
         }
     };
 
@@ -0,0 +1,32 @@
+import FWCore.ParameterSet.Config as cms
+
+
+# -- write side: convert karma collections to the compact formats
+
+karmaCompactJets = cms.EDProducer(
+    "CompactJetCollectionProducer",
+    cms.PSet(
+        inputCollection = cms.InputTag("karmaJets"),
+    )
+)
+karmaCompactGenJets = cms.EDProducer(
+    "CompactLVCollectionProducer",
+    cms.PSet(
+        inputCollection = cms.InputTag("karmaGenJetsAK4"),
+    )
+)
+
+# -- read side: convert compact collections back to karma collections
+
+karmaJetsFromCompact = cms.EDProducer(
+    "JetCollectionFromCompactProducer",
+    cms.PSet(
+        inputCollection = cms.InputTag("karmaCompactJets"),
+    )
+)
+karmaGenJetsFromCompact = cms.EDProducer(
+    "LVCollectionFromCompactProducer",
+    cms.PSet(
+        inputCollection = cms.InputTag("karmaCompactGenJets"),
+    )
+)
@@ -53,6 +53,10 @@ def register_options(options):
                       type_=str,
                       default=None,
                       description="Name of the process whose TriggerResults contain the MET filters (e.g. 'RECO').")
+            .register('withCompactJets',
+                      type_=bool,
+                      default=False,
+                      description="If True, jet and gen-jet collections will additionally be written out in the compact (single-precision) format.")
     )
 
 def configure(process, options):
@@ -420,6 +424,7 @@ def configure(process, options):
     # -- Jets -------------------------------------------------------------
 
     from Karma.Skimming.JetCollectionProducer_cfi import karmaJets
+    from Karma.Skimming.CompactCollectionProducers_cfi import karmaCompactJets
     from Karma.Skimming.JetCorrectedLVValueMapProducer_cfi import karmaJetCorrectedLVValueMapProducer, karmaJetCorrectedLVValueMapProducerForPuppi
     from Karma.Skimming.JetIdValueMapProducers_cfi import karmaJetIdValueMapProducer, karmaJetPileupIdValueMapProducer, karmaJetPileupIdDiscriminantValueMapProducer
 
@@ -437,6 +442,17 @@ def configure(process, options):
             write_out=True,
         )
 
+        # add compact (single-precision) copy of the jet collection, if requested
+        if options.withCompactJets:
+            process.add_module(
+                "karmaCompact{}{}".format(_jet_collection_name[0].upper(), _jet_collection_name[1:]),
+                karmaCompactJets.clone(
+                    inputCollection = cms.InputTag(_module_name),
+                ),
+                on_path='path',
+                write_out=True,
+            )
+
         # write out jet ID information to transients (used to fill value maps)
         _t = getattr(process, _module_name).transientInformationSpec
         _t.fromUserIntAsBool = cms.PSet(
@@ -522,6 +538,19 @@ def configure(process, options):
             write_out=True,
         )
 
+        # add compact (single-precision) copies of the gen-jet collections, if requested
+        if options.withCompactJets:
+            from Karma.Skimming.CompactCollectionProducers_cfi import karmaCompactGenJets
+            for _gen_jet_module_name in ('karmaGenJetsAK4', 'karmaGenJetsAK8'):
+                process.add_module(
+                    _gen_jet_module_name.replace('karma', 'karmaCompact', 1),
+                    karmaCompactGenJets.clone(
+                        inputCollection = cms.InputTag(_gen_jet_module_name),
+                    ),
+                    on_path='path',
+                    write_out=True,
+                )
+
     # -- Photons ----------------------------------------------------------
 
     from Karma.Skimming.PhotonCollectionProducer_cfi import karmaPhotonCollectionProducer
@@ -544,19 +573,6 @@ def configure(process, options):
         write_out=True,
     )
 
-    # -- Electron IDs -----------------------------------------------------
-
-    from Karma.Skimming.ElectronIdValueMapProducer_cfi import karmaElectronIdValueMapProducer
-
-    process.add_module(
-        'karmaElectronIds',
-        karmaElectronIdValueMapProducer.clone(
-            inputCollection = cms.InputTag("karmaElectrons")
-        ),
-        on_path='path',
-        write_out=True
-    )
-
     # -- Muons ------------------------------------------------------------
 
     from Karma.Skimming.MuonCollectionProducer_cfi import karmaMuonCollectionProducer
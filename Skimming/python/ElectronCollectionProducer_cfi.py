@@ -6,6 +6,9 @@ karmaElectronCollectionProducer = cms.EDProducer(
     cms.PSet(
         inputCollection = cms.InputTag("slimmedElectrons"),
         produceEcalTrkEnergyCorrections = cms.bool(True),
+        # electron Id decisions are stored in `karma::Electron::idBits`:
+        # bit `8 * i + j` is set if working point `j` of Id `i` is passed
+        # (at most 4 Ids with 8 working points each)
         electronIds = cms.VPSet(
             cms.PSet(
                 name = cms.string("Summer16-80X-V1"),
@@ -20,12 +20,18 @@ def karmaEventProducer(isData):
             # -- other configuration
             isData = cms.bool(isData),
             writeOutTriggerPrescales = cms.bool(False),
+            # if True, check that the prescales cached per lumi section match those of each event
+            verifyCachedTriggerPrescales = cms.bool(False),
 
             # name of the HLT process (for HLTConfigProvider)
             hltProcessName = cms.string("HLT"),
 
             # HLTPrescaleProvider (similar to HLTConfigProvider) configuration
+            # (the HLT prescale set index is obtained from the Stage-2 L1 global trigger record)
             hltConfigAndPrescaleProvider = cms.PSet(
+                stageL1Trigger = cms.uint32(2),
+                l1tAlgBlkInputTag = cms.InputTag("gtStage2Digis"),
+                l1tExtBlkInputTag = cms.InputTag("gtStage2Digis"),
                 l1GtRecordInputTag = cms.InputTag("l1GtTriggerMenuLite"),
                 l1GtReadoutRecordInputTag = cms.InputTag(""),
                 l1GtTriggerMenuLiteInputTag =  cms.InputTag("l1GtTriggerMenuLite"),
@@ -9,5 +9,9 @@ karmaGenParticleCollectionProducer = cms.EDProducer(
              1,  2,  3,  4,  5,  6,  9,  11,  12,  13,  14,  15,  16,  21,  22,  23,  24,
             -1, -2, -3, -4, -5, -6,     -11, -12, -13, -14, -15, -16,                -24
         ),
+        # process input collections with at least this many elements
+        # in parallel chunks (0: disabled)
+        parallelMinInputSize = cms.uint32(0),
+        parallelChunkSize = cms.uint32(1024),
     )
 )
@@ -1,20 +1,34 @@
 import FWCore.ParameterSet.Config as cms
 
 
+# parameters shared by the jet collection producers below
+# (each producer gets its own copy)
+_jetCollectionProducerParameters = cms.PSet(
+    # take miniAOD AK4 jets by default
+    inputCollection = cms.InputTag("slimmedJets"),
+
+    # information to be filled into transient maps
+    # it can then be accessed by other producers (e.g.
+    # ValueMap producers)
+    transientInformationSpec = cms.PSet(
+        fromUserInt = cms.PSet(),
+        fromUserIntAsBool = cms.PSet(),
+        fromUserFloat = cms.PSet()
+    ),
+
+    # if True, check the JEC levels (resolved once per run) and user
+    # data against a lookup by name for every jet (slow)
+    validateResolvedJECLevels = cms.bool(False),
+)
+
 karmaJets = cms.EDProducer(
     "JetCollectionProducer",
-    cms.PSet(
-        # take miniAOD AK4 jets by default
-        inputCollection = cms.InputTag("slimmedJets"),
-
-        # information to be filled into transient maps
-        # it can then be accessed by other producers (e.g.
-        # ValueMap producers)
-        transientInformationSpec = cms.PSet(
-            fromUserInt = cms.PSet(),
-            fromUserIntAsBool = cms.PSet(),
-            fromUserFloat = cms.PSet()
-        ),
+    _jetCollectionProducerParameters.clone()
+)
 
-    )
+# same as above, but write out the jets as a structure of arrays
+# (`karma::JetSoACollection`) for partial-column reads
+karmaJetSoAs = cms.EDProducer(
+    "JetSoACollectionProducer",
+    _jetCollectionProducerParameters.clone()
 )
@@ -0,0 +1,18 @@
+#include "Karma/Skimming/interface/CompactCollectionProducers.h"
+
+
+//define this as a plug-in
+using karma::CompactLVCollectionProducer;
+DEFINE_FWK_MODULE(CompactLVCollectionProducer);
+
+//define this as a plug-in
+using karma::CompactJetCollectionProducer;
+DEFINE_FWK_MODULE(CompactJetCollectionProducer);
+
+//define this as a plug-in
+using karma::LVCollectionFromCompactProducer;
+DEFINE_FWK_MODULE(LVCollectionFromCompactProducer);
+
+//define this as a plug-in
+using karma::JetCollectionFromCompactProducer;
+DEFINE_FWK_MODULE(JetCollectionFromCompactProducer);
@@ -25,37 +25,31 @@ void karma::ElectronCollectionProducer::produceSingle(const pat::Electron& in, k
         out.ecalTrkEnergyPostCorr = in.userFloat("ecalTrkEnergyPostCorr");
     }
 
-    // retrieve electron Ids and store in transient map
-    for (const auto& electronIdTagAndWorkingPoints : m_electronIdSpecs) {
-        int electronIDCompact = 0;
+    // retrieve electron Ids and store decisions in bit mask
+    // (indices resolved once per run, see `resolveElectronIds()`)
+    const std::vector<pat::Electron::IdPair>& electronIds = in.electronIDs();
+    if (electronIds.size() != m_numAvailableElectronIds) {
+        edm::Exception exception(edm::errors::LogicError);
+        exception << "Electron has " << electronIds.size() << " electron Ids, but "
+                  << m_numAvailableElectronIds << " were available for the first electron in the run!";
+        throw exception;
+    }
 
+    out.idBits = 0;
+    for (size_t iId = 0; iId < m_electronIdIndices.size(); ++iId) {
         bool looserWPFailed = false;
-        for (const auto& workingPoint : electronIdTagAndWorkingPoints.second) {
-            // check if tag exists (and throw)
-            if (!in.isElectronIDAvailable(workingPoint)) {
-                edm::Exception exception(edm::errors::NotFound);
-                exception << "Could not find electron Id with tag '"
-                          << workingPoint << "' "
-                          << "in user data of product '"
-                          << this->inputCollectionHandle_.provenance()->branchName()
-                          <<  "'. Available tags are: ";
-                const std::vector<pat::Electron::IdPair>& availableIDs = in.electronIDs();
-                for (size_t iID = 0; iID < availableIDs.size(); ++iID) {
-                    exception << ((iID == 0) ? "" : ", ") << availableIDs[iID].first;
-                }
-                throw exception;
-            }
-
+        for (size_t iWorkingPoint = 0; iWorkingPoint < m_electronIdIndices[iId].size(); ++iWorkingPoint) {
             // sanity check: tighter IDs should all fail if looser ID fails
-            bool result = static_cast<bool>(in.electronID(workingPoint));
+            bool result = static_cast<bool>(electronIds[m_electronIdIndices[iId][iWorkingPoint]].second);
             if (looserWPFailed && result) {
                 // electron failed looser WP, but it would pass this one -> throw!
+                const auto& workingPoints = m_electronIdSpecs.workingPointNames[iId];
                 edm::Exception exception(edm::errors::LogicError);
                 exception << "Electron passes tighter Id '"
-                          << workingPoint << "' despite failing previous, looser ones!"
+                          << workingPoints[iWorkingPoint] << "' despite failing previous, looser ones!"
                           << "The specified ID sequence, from loose to tight, was: ";
-                for (size_t iName = 0; iName < electronIdTagAndWorkingPoints.second.size(); ++iName) {
-                    exception << ((iName == 0) ? "" : ", ") << electronIdTagAndWorkingPoints.second[iName];
+                for (size_t iName = 0; iName < workingPoints.size(); ++iName) {
+                    exception << ((iName == 0) ? "" : ", ") << workingPoints[iName];
                 }
                 throw exception;
             }
@@ -63,13 +57,47 @@ void karma::ElectronCollectionProducer::produceSingle(const pat::Electron& in, k
             // set flag if current working point failed
             looserWPFailed |= (!result);
 
-            // all OK -> increment compact ID
-            if (result) ++electronIDCompact;
+            // all OK -> set bit for working point
+            if (result) out.idBits |= karma::Electron::idMask(iId, iWorkingPoint);
         }
-        out.transientInts_[electronIdTagAndWorkingPoints.first] = electronIDCompact;
     }
 }
 
+void karma::ElectronCollectionProducer::resolveElectronIds(const pat::Electron& electron) {
+
+    const std::vector<pat::Electron::IdPair>& availableIDs = electron.electronIDs();
+
+    m_electronIdIndices.clear();
+    for (const auto& workingPoints : m_electronIdSpecs.workingPointNames) {
+        m_electronIdIndices.emplace_back();
+        for (const auto& workingPoint : workingPoints) {
+            const auto& it = std::find_if(
+                availableIDs.begin(), availableIDs.end(),
+                [&workingPoint](const pat::Electron::IdPair& idPair) { return idPair.first == workingPoint; }
+            );
+
+            // check if tag exists (and throw)
+            if (it == availableIDs.end()) {
+                edm::Exception exception(edm::errors::NotFound);
+                exception << "Could not find electron Id with tag '"
+                          << workingPoint << "' "
+                          << "in user data of product '"
+                          << this->inputCollectionHandle_.provenance()->branchName()
+                          <<  "'. Available tags are: ";
+                for (size_t iID = 0; iID < availableIDs.size(); ++iID) {
+                    exception << ((iID == 0) ? "" : ", ") << availableIDs[iID].first;
+                }
+                throw exception;
+            }
+
+            m_electronIdIndices.back().push_back(std::distance(availableIDs.begin(), it));
+        }
+    }
+    m_numAvailableElectronIds = availableIDs.size();
+
+    m_electronIdsResolved = true;
+}
+
 bool karma::ElectronCollectionProducer::acceptSingle(const pat::Electron& in, const edm::Event& event, const edm::EventSetup& setup) {
     // accept all electrons
     return true;
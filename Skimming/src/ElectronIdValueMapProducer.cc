@@ -1,6 +0,0 @@
-#include "Karma/Skimming/interface/ElectronIdValueMapProducer.h"
-
-
-//define this as a plug-in
-using karma::ElectronIdValueMapProducer;
-DEFINE_FWK_MODULE(ElectronIdValueMapProducer);
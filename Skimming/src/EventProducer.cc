@@ -15,7 +15,11 @@
 karma::EventProducer::EventProducer(const edm::ParameterSet& config, const karma::GlobalCache* globalCache) : m_configPSet(config) {
     // -- register products
     produces<karma::Event>();
-    produces<karma::Lumi, edm::InLumi>();
+    #if CMSSW_MAJOR_VERSION > 8
+        produces<karma::Lumi, edm::Transition::EndLuminosityBlock>();
+    #else
+        produces<karma::Lumi, edm::InLumi>();
+    #endif
     produces<karma::Run, edm::InRun>();
 
     // -- process configuration
@@ -81,33 +85,28 @@ karma::EventProducer::~EventProducer() {
     karma::HLTPathInfos* hltPathInfos = &(runCache->hltPathInfos_);
     size_t filtersNextStartIndex = 0;
 
+    // match trigger names against the configured path regexes
+    // (memoized per trigger menu and shared between modules)
+    const auto matchedPathIndices = karma::TriggerMenuRegistry::instance().matchPaths(
+        runCache->hltMenuName_, globalCache->hltConfigProvider_.triggerNames(), globalCache->hltPathRegexes_);
+    auto itMatchedPathIndex = matchedPathIndices->begin();
+
     for (size_t iHLTPath = 0; iHLTPath < globalCache->hltConfigProvider_.size(); ++iHLTPath) {
-        // get trigger path information
-        const std::string& name = globalCache->hltConfigProvider_.triggerName(iHLTPath);
-        size_t idxInMenu = globalCache->hltConfigProvider_.triggerIndex(name);
-        const std::vector<std::string>& filterNames = globalCache->hltConfigProvider_.saveTagsModules(idxInMenu);
-
-        // skip triggers that don't match the configured path regexes
-        bool regexMatch = false;
-        std::cout << "Match('" << name << "')? -> ";
-        for (const auto& regex : globalCache->hltPathRegexes_) {
-            if (boost::regex_search(name, regex)) {
-                regexMatch = true;
-                std::cout << " yes ";
-                break;
-            }
-            else std::cout << " no ";
-        }
-        std::cout << std::endl;
+        const std::vector<std::string>& filterNames = globalCache->hltConfigProvider_.saveTagsModules(iHLTPath);
 
         // only save interesting trigger paths
-        if (regexMatch) {
+        if ((itMatchedPathIndex != matchedPathIndices->end()) && (*itMatchedPathIndex == iHLTPath)) {
+            // get trigger path information
+            const std::string& name = globalCache->hltConfigProvider_.triggerName(iHLTPath);
+            size_t idxInMenu = globalCache->hltConfigProvider_.triggerIndex(name);
+
             hltPathInfos->emplace_back(
                 /*name = */name,
                 /*indexInMenu = */idxInMenu,
                 /*filtersStartIndex = */filtersNextStartIndex,
                 /*filterNames = */filterNames
             );
+            ++itMatchedPathIndex;
         }
 
         // keep track of the index at which filters start for each HLT path
@@ -166,7 +165,8 @@ karma::EventProducer::~EventProducer() {
 
 
     // -- populate the LumiCache
-    // nothing to do
+    lumiCache->karmaLumi_.run = lumi.run();
+    lumiCache->karmaLumi_.lumi = lumi.luminosityBlock();
 
     return lumiCache;
 }
@@ -183,24 +183,71 @@ karma::EventProducer::~EventProducer() {
     run.put(std::move(karmaRun));
 }
 
-/*static*/ void karma::EventProducer::globalBeginLuminosityBlockProduce(edm::LuminosityBlock& lumi, const edm::EventSetup& setup, const LuminosityBlockContext* lumiContext) {
+/*static*/ void karma::EventProducer::globalEndLuminosityBlockProduce(edm::LuminosityBlock& lumi, const edm::EventSetup& setup, const LuminosityBlockContext* lumiContext) {
+    // -- luminosity block data (incl. trigger prescale table) was
+    //    populated in the LumiCache while processing the events
     #if CMSSW_MAJOR_VERSION > 8
-        std::unique_ptr<karma::Lumi> karmaLumi(new karma::Lumi()); // -> use unique_ptr
+        std::unique_ptr<karma::Lumi> karmaLumi(new karma::Lumi(lumiContext->luminosityBlock()->karmaLumi_)); // -> use unique_ptr
     #else
         // bug in CMSSW8: upstream code missing "std::move" for unique_ptr
-        std::auto_ptr<karma::Lumi> karmaLumi(new karma::Lumi());  //  -> substitute auto_ptr
+        std::auto_ptr<karma::Lumi> karmaLumi(new karma::Lumi(lumiContext->luminosityBlock()->karmaLumi_));  //  -> substitute auto_ptr
     #endif
 
-    // -- populate luminosity block data and fill Lumi tree
-    karmaLumi->run = lumi.run();
-    karmaLumi->lumi = lumi.luminosityBlock();
-
     lumi.put(std::move(karmaLumi));
 }
 
 
 // -- member functions
 
+void karma::EventProducer::beginRun(const edm::Run& run, const edm::EventSetup& setup) {
+    // (re-)initialize the HLTPrescaleProvider once per run and stream
+    bool hltChanged(true);
+    bool hltInitSuccess = m_hltPrescaleProvider->init(run, setup, globalCache()->hltProcessName_, hltChanged);
+    assert(hltInitSuccess);
+
+    m_warnedUnknownTriggerPrescaleSet = false;
+}
+
+
+void karma::EventProducer::beginLuminosityBlock(const edm::LuminosityBlock& lumi, const edm::EventSetup& setup) {
+    // prescales can change at luminosity block boundaries: invalidate cached prescale set
+    m_triggerPrescaleSet = -1;
+}
+
+
+karma::TriggerPrescaleColumn karma::EventProducer::getTriggerPrescaleColumn(const edm::Event& event, const edm::EventSetup& setup) {
+    karma::util::getByTokenOrThrow(event, this->triggerPrescalesToken, this->triggerPrescalesHandle);
+    karma::util::getByTokenOrThrow(event, this->triggerPrescalesL1MinToken, this->triggerPrescalesL1MinHandle);
+    // define if ever needed
+    //karma::util::getByTokenOrThrow(event, this->triggerPrescalesL1MaxToken, this->triggerPrescalesL1MaxHandle);
+
+    const size_t numSelectedHLTPaths = runCache()->hltPathInfos_.size();
+    karma::TriggerPrescaleColumn prescaleColumn;
+
+    // the prescale set index identifies the column independently of the job
+    // or stream that wrote it, so it is used as the key in the per-lumi table
+    // (-1 if it cannot be determined, e.g. for MC without L1 prescale information)
+    prescaleColumn.prescaleSet = m_hltPrescaleProvider->prescaleSet(event, setup);
+
+    prescaleColumn.hltPrescales.resize(numSelectedHLTPaths);
+    prescaleColumn.l1Prescales.resize(numSelectedHLTPaths);
+    for (size_t iPath = 0; iPath < numSelectedHLTPaths; ++iPath) {
+        // need the original index of the path in the trigger menu to obtain trigger prescale
+        const int& triggerIndex = runCache()->hltPathInfos_[iPath].indexInMenu_;
+
+        // old prescales code: keep for reference
+        //const std::pair<int, int> l1AndHLTPrescales = m_hltPrescaleProvider->prescaleValues(event, setup, triggerName);
+        //prescaleColumn.l1Prescales[iPath] = l1AndHLTPrescales.first;
+        //prescaleColumn.hltPrescales[iPath] = l1AndHLTPrescales.second;
+
+        prescaleColumn.hltPrescales[iPath] = this->triggerPrescalesHandle->getPrescaleForIndex(triggerIndex);
+        prescaleColumn.l1Prescales[iPath] = this->triggerPrescalesL1MinHandle->getPrescaleForIndex(triggerIndex);
+    }
+
+    return prescaleColumn;
+}
+
+
 void karma::EventProducer::produce(edm::Event& event, const edm::EventSetup& setup) {
     //std::unique_ptr<karma::Event> karmaEvent(new karma::Event());
     std::unique_ptr<karma::Event> outputEvent(new karma::Event());
@@ -213,9 +260,7 @@ void karma::EventProducer::produce(edm::Event& event, const edm::EventSetup& set
     karma::util::getByTokenOrThrow(event, this->triggerResultsToken, this->triggerResultsHandle);
     // MET filters
     karma::util::getByTokenOrThrow(event, this->metFiltersToken, this->metFiltersHandle);
-    karma::util::getByTokenOrThrow(event, this->triggerPrescalesToken, this->triggerPrescalesHandle);
-    karma::util::getByTokenOrThrow(event, this->triggerPrescalesL1MinToken, this->triggerPrescalesL1MinHandle);
-    karma::util::getByTokenOrThrow(event, this->triggerPrescalesL1MaxToken, this->triggerPrescalesL1MaxHandle);
+    // (trigger prescales are only retrieved when needed, see below)
     // primary vertices
     karma::util::getByTokenOrThrow(event, this->primaryVerticesToken, this->primaryVerticesHandle);
     karma::util::getByTokenOrThrow(event, this->goodPrimaryVerticesToken, this->goodPrimaryVerticesHandle);
@@ -242,39 +287,52 @@ void karma::EventProducer::produce(edm::Event& event, const edm::EventSetup& set
         }
     }
 
-    // -- trigger decisions (bits) and prescales
-    bool hltChanged(true);
-    // must be called on each event, since there is no guarantee that
-    // the HLTPrescaleProvider has been re-initialized correctly on new run transition
-    bool hltInitSuccess = m_hltPrescaleProvider->init(event.getRun(), setup, globalCache()->hltProcessName_, hltChanged);
-    assert(hltInitSuccess);
-
+    // -- trigger decisions (bits)
     const size_t numSelectedHLTPaths = runCache()->hltPathInfos_.size();
     outputEvent->hltBits.resize(numSelectedHLTPaths);
-    if (globalCache()->writeOutTriggerPrescales_) {
-        outputEvent->triggerPathHLTPrescales.resize(numSelectedHLTPaths);
-        outputEvent->triggerPathL1Prescales.resize(numSelectedHLTPaths);
-        //outputEvent->triggerPathL1PrescalesMax.resize(numSelectedHLTPaths);
-    }
     for (size_t iPath = 0; iPath < numSelectedHLTPaths; ++iPath) {
         // need the original index of the path in the trigger menu to obtain trigger decision
         const int& triggerIndex = runCache()->hltPathInfos_[iPath].indexInMenu_;
-        // need the full trigger name to obtain trigger prescale
-        const std::string& triggerName = runCache()->hltPathInfos_[iPath].name_;
 
         outputEvent->hltBits[iPath] = this->triggerResultsHandle->accept(triggerIndex);
+    }
 
-        if (globalCache()->writeOutTriggerPrescales_) {
-            // old prescales code: keep for reference
-            //const std::pair<int, int> l1AndHLTPrescales = m_hltPrescaleProvider->prescaleValues(event, setup, triggerName);
-            //outputEvent->triggerPathL1Prescales[iPath] = l1AndHLTPrescales.first;
-            //outputEvent->triggerPathHLTPrescales[iPath] = l1AndHLTPrescales.second;
-
-            outputEvent->triggerPathHLTPrescales[iPath] = this->triggerPrescalesHandle->getPrescaleForIndex(triggerIndex);
-            outputEvent->triggerPathL1Prescales[iPath] = this->triggerPrescalesL1MinHandle->getPrescaleForIndex(triggerIndex);
-            // define if ever needed
-            ///outputEvent->triggerPathL1PrescalesMax[iPath] = this->triggerPrescalesL1MaxHandle->getPrescaleForIndex(triggerIndex);
+    // -- trigger prescales
+    //    prescales change at most once per lumi section: they are collected in a
+    //    column on the first event of the lumi section seen by this stream, and only
+    //    the HLT prescale set index (the key of the column in the per-lumi prescale
+    //    table) is stored in the event
+    if (globalCache()->writeOutTriggerPrescales_) {
+        if ((m_triggerPrescaleSet < 0) || globalCache()->verifyCachedTriggerPrescales_) {
+            karma::TriggerPrescaleColumn prescaleColumn = getTriggerPrescaleColumn(event, setup);
+
+            if (prescaleColumn.prescaleSet < 0) {
+                // prescale set unknown (e.g. MC): the column cannot be keyed in the
+                // per-lumi table, so store the prescales in the event instead
+                if (!m_warnedUnknownTriggerPrescaleSet) {
+                    edm::LogWarning("EventProducer")
+                        << "Cannot determine the HLT prescale set for event " << event.id() << ": "
+                        << "storing the trigger prescales in the event instead (reported once per run and stream)";
+                    m_warnedUnknownTriggerPrescaleSet = true;
+                }
+                outputEvent->triggerPathHLTPrescales = std::move(prescaleColumn.hltPrescales);
+                outputEvent->triggerPathL1Prescales = std::move(prescaleColumn.l1Prescales);
+            }
+            else {
+                // lumi cache is shared by all streams
+                std::lock_guard<std::mutex> lock(luminosityBlockCache()->karmaLumiMutex_);
+                // compare column stored for the prescale set to the prescales obtained for this event
+                if (!(luminosityBlockCache()->karmaLumi_.addTriggerPrescaleColumn(prescaleColumn) == prescaleColumn)) {
+                    edm::Exception exception(edm::errors::LogicError);
+                    exception
+                        << "Trigger prescales for event " << event.id() << " differ from the prescales "
+                        << "cached for HLT prescale set " << prescaleColumn.prescaleSet << " in the luminosity block!";
+                    throw exception;
+                }
+                m_triggerPrescaleSet = prescaleColumn.prescaleSet;
+            }
         }
+        outputEvent->triggerPrescaleSet = m_triggerPrescaleSet;
     }
 
     // retrieve met filter results
@@ -1,11 +1,72 @@
 #include "Karma/Skimming/interface/JetCollectionProducer.h"
 
 
-void karma::JetCollectionProducer::produceSingle(const pat::Jet& in, karma::Jet& out, const edm::Event& event, const edm::EventSetup& setup) {
+template<typename TOutputCollection>
+void karma::GenericJetCollectionProducer<TOutputCollection>::resolveJECLevels(const pat::Jet& jet) {
+
+    const std::vector<std::string> jecLevelNames = jet.availableJECLevels();
+
+    m_jecLevels.clear();
+    m_jecLevelIndexUncorrected = -1;
+    for (unsigned int iLevel = 0; iLevel < jecLevelNames.size(); ++iLevel) {
+        m_jecLevels.push_back({iLevel, karma::TransientKey(jecLevelNames[iLevel])});
+        if (jecLevelNames[iLevel] == "Uncorrected") {
+            m_jecLevelIndexUncorrected = iLevel;
+        }
+    }
+
+    // fill transient map in key order (entries are appended at the end)
+    std::sort(
+        m_jecLevels.begin(), m_jecLevels.end(),
+        [](const ResolvedJECLevel& a, const ResolvedJECLevel& b) { return a.transientKey.id() < b.transientKey.id(); }
+    );
+
+    m_jecLevelsResolved = true;
+}
+
+
+template<typename TOutputCollection>
+void karma::GenericJetCollectionProducer<TOutputCollection>::validateSingle(const pat::Jet& in, const karma::Jet& out, const edm::Event& event) const {
+
+    // reference: JEC levels and user data looked up by name
+    karma::Jet reference;
+    reference.uncorP4 = in.correctedP4("Uncorrected");
+    for (const std::string& jecLevel : in.availableJECLevels()) {
+        reference.transientLVs_[jecLevel] = in.correctedP4(jecLevel);
+    }
+    for (const auto& userVarNameAndTransientKey : m_transientBoolKeyForUserInt) {
+        reference.transientBools_[userVarNameAndTransientKey.second.name()] = static_cast<bool>(in.userInt(userVarNameAndTransientKey.first));
+    }
+    for (const auto& userVarNameAndTransientKey : m_transientIntKeyForUserInt) {
+        reference.transientInts_[userVarNameAndTransientKey.second.name()] = static_cast<int>(in.userInt(userVarNameAndTransientKey.first));
+    }
+    for (const auto& userVarNameAndTransientKey : m_transientDoubleKeyForUserFloat) {
+        reference.transientDoubles_[userVarNameAndTransientKey.second.name()] = static_cast<double>(in.userFloat(userVarNameAndTransientKey.first));
+    }
+
+    const bool isEqual = (
+        (out.uncorP4 == reference.uncorP4) &&
+        std::equal(out.transientLVs_.begin(), out.transientLVs_.end(), reference.transientLVs_.begin(), reference.transientLVs_.end()) &&
+        std::equal(out.transientBools_.begin(), out.transientBools_.end(), reference.transientBools_.begin(), reference.transientBools_.end()) &&
+        std::equal(out.transientInts_.begin(), out.transientInts_.end(), reference.transientInts_.begin(), reference.transientInts_.end()) &&
+        std::equal(out.transientDoubles_.begin(), out.transientDoubles_.end(), reference.transientDoubles_.begin(), reference.transientDoubles_.end())
+    );
+    if (!isEqual) {
+        edm::Exception exception(edm::errors::LogicError);
+        exception
+            << "JEC levels or user data of jet with pt " << in.pt() << " in event " << event.id() << " differ from "
+            << "the lookup by name! Do the available JEC levels change within the run?";
+        throw exception;
+    }
+}
+
+
+template<typename TOutputCollection>
+void karma::GenericJetCollectionProducer<TOutputCollection>::produceSingle(const pat::Jet& in, karma::Jet& out, const edm::Event& event, const edm::EventSetup& setup) {
 
     // populate the output object
     out.p4 = in.p4();
-    out.uncorP4 = in.correctedP4("Uncorrected");
+    out.uncorP4 = (m_jecLevelIndexUncorrected >= 0) ? in.correctedP4(static_cast<unsigned int>(m_jecLevelIndexUncorrected)) : in.correctedP4("Uncorrected");
 
     out.area = in.jetArea();
 
@@ -29,26 +90,39 @@ void karma::JetCollectionProducer::produceSingle(const pat::Jet& in, karma::Jet&
     out.hfEMFraction = in.HFEMEnergyFraction();
 
     // store the different JEC levels in one of the transient maps
-    for (const std::string& jecLevel : in.availableJECLevels()) {
-        out.transientLVs_[jecLevel] = in.correctedP4(jecLevel);
+    // (levels resolved once per run, see `resolveJECLevels()`)
+    out.transientLVs_.reserve(m_jecLevels.size());
+    for (const auto& jecLevel : m_jecLevels) {
+        out.transientLVs_[jecLevel.transientKey] = in.correctedP4(jecLevel.levelIndex);
     }
 
     // write out embedded user data to transient maps
+    out.transientBools_.reserve(m_transientBoolKeyForUserInt.size());
     for ( const auto& userVarNameAndTransientKey : m_transientBoolKeyForUserInt) {
         out.transientBools_[userVarNameAndTransientKey.second] =
             static_cast<bool>(in.userInt(userVarNameAndTransientKey.first));
     }
+    out.transientInts_.reserve(m_transientIntKeyForUserInt.size());
     for ( const auto& userVarNameAndTransientKey : m_transientIntKeyForUserInt) {
         out.transientInts_[userVarNameAndTransientKey.second] =
             static_cast<int>(in.userInt(userVarNameAndTransientKey.first));
     }
+    out.transientDoubles_.reserve(m_transientDoubleKeyForUserFloat.size());
     for ( const auto& userVarNameAndTransientKey : m_transientDoubleKeyForUserFloat) {
         out.transientDoubles_[userVarNameAndTransientKey.second] =
             static_cast<double>(in.userFloat(userVarNameAndTransientKey.first));
     }
+
+    if (m_validateResolvedJECLevels) {
+        validateSingle(in, out, event);
+    }
 }
 
 
 //define this as a plug-in
 using karma::JetCollectionProducer;
 DEFINE_FWK_MODULE(JetCollectionProducer);
+
+//define this as a plug-in
+using karma::JetSoACollectionProducer;
+DEFINE_FWK_MODULE(JetSoACollectionProducer);
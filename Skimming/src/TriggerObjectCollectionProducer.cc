@@ -1,26 +1,60 @@
 #include "Karma/Skimming/interface/TriggerObjectCollectionProducer.h"
 
 
+void karma::TriggerObjectCollectionProducer::beginRun(const edm::Run& run, const edm::EventSetup& setup) {
+    // get the active trigger path names for this run
+    karma::util::getByTokenOrThrow(run, this->karmaRunToken_, this->karmaRunHandle_);
+
+    // path names are unique within a trigger menu
+    selectedPathIndicesByName_.clear();
+    for (size_t iPath = 0; iPath < this->karmaRunHandle_->triggerPathInfos.size(); ++iPath) {
+        selectedPathIndicesByName_.emplace(this->karmaRunHandle_->triggerPathInfos[iPath].name_, iPath);
+    }
+}
+
+
+void karma::TriggerObjectCollectionProducer::produce(edm::Event& event, const edm::EventSetup& setup) {
+    // get additional event data
+    karma::util::getByTokenOrThrow(event, this->triggerResultsToken_, this->triggerResultsHandle_);
+    const edm::TriggerNames& triggerNames = event.triggerNames(*this->triggerResultsHandle_);
+
+    // assign the selected paths to each input object
+    // (path names are unpacked once per object, in a scratch copy which is
+    //  assigned to for every object, so that its buffers are reused)
+    karma::util::getByTokenOrThrow(event, this->inputCollectionToken_, this->inputCollectionHandle_);
+    const auto& inputCollection = *this->inputCollectionHandle_;
+    assignedPathIndicesPerObject_.resize(inputCollection.size());
+    for (size_t iObject = 0; iObject < inputCollection.size(); ++iObject) {
+        unpackedObject_ = inputCollection[iObject];
+        unpackedObject_.unpackPathNames(triggerNames);
+
+        std::vector<int>& assignedPathIndices = assignedPathIndicesPerObject_[iObject];
+        assignedPathIndices.clear();
+        for (const auto& triggeredPathName : unpackedObject_.pathNames()) {
+            const auto& it = selectedPathIndicesByName_.find(triggeredPathName);
+            if (it != selectedPathIndicesByName_.end()) {
+                assignedPathIndices.emplace_back(it->second);
+            }
+        }
+    }
+
+    // call "parent" fill loop (devirtualized, since this class is final)
+    this->produceCollection(*this, event, setup);
+}
+
+
 void karma::TriggerObjectCollectionProducer::produceSingle(const pat::TriggerObjectStandAlone& in, karma::TriggerObject& out, const edm::Event& event, const edm::EventSetup& setup) {
 
     // populate the output object
     out.p4 = in.p4();
     out.types = in.triggerObjectTypes();
 
-    // unpack trigger path information in input trigger object
-    const_cast<pat::TriggerObjectStandAlone&>(in).unpackPathNames(event.triggerNames(*this->triggerResultsHandle_));
-
     // use trigger path information in karmaEvent
-    // and 'pathL3FilterAccepted'
-    for (const auto& triggeredPathName : in.pathNames()) {
-        for (size_t iPath = 0; iPath < this->karmaRunHandle_->triggerPathInfos.size(); ++iPath) {
-            const auto& pathInfo = this->karmaRunHandle_->triggerPathInfos[iPath];
-            if (pathInfo.name_ == triggeredPathName) {
-                out.assignedPathIndices.emplace_back(iPath);
-                break;
-            }
-        }
-    }
+    // (path names were already unpacked and matched in `produce()`)
+    out.assignedPathIndices = this->assignedPathIndices(in);
+
+    // pack type information and path assignments for fast lookups
+    out.packFlags(this->karmaRunHandle_->triggerPathInfos.size());
 
     // // use trigger filter information in karmaEvent
     // for (const auto& triggeredFilterName : in.filterLabels()) {
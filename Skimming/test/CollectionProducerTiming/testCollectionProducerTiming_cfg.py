@@ -0,0 +1,85 @@
+"""
+Timing of the karma collection producers on MiniAOD
+===================================================
+
+Runs the full dijet skim on a MiniAOD file with the `Timing` service enabled,
+so that the time spent in each module is reported for every event. This can
+be used to measure the fill loop of `CollectionProducerBase` with the real
+producers and inputs, by running the same config on two versions of the code
+and comparing the averages for the `karma*` modules.
+
+The large collections written by the skim are the gen particles
+(`karmaGenParticles`) and the trigger objects (`karmaTriggerObjects`). There is
+no producer for packed PF candidates in this package, so these are not covered.
+
+To use (one thread, same input and number of events for both versions):
+
+    cmsRun testCollectionProducerTiming_cfg.py maxEvents=2000 2>&1 | tee timing_baseline.log
+    # ... switch to the other version of the code and rebuild ...
+    cmsRun testCollectionProducerTiming_cfg.py maxEvents=2000 2>&1 | tee timing_head.log
+
+    # average time per event (in microseconds) for both versions, and their ratio
+    compareModuleTiming.py timing_baseline.log timing_head.log --modules karmaGenParticles karmaTriggerObjects
+
+Large input collections can optionally be processed in parallel chunks by the
+reentrant producers (`parallelMinInputSize=<N>`, with `numThreads` > 1).
+"""
+import FWCore.ParameterSet.Config as cms
+
+from Karma.Common.Tools import KarmaOptions, KarmaProcess
+from Karma.Skimming.Configuration.MiniAOD import dijetSkim_94X_Run2016_17Jul2018
+
+
+# set up and parse command-line options
+options = (
+    dijetSkim_94X_Run2016_17Jul2018.register_options(KarmaOptions())
+        .register('parallelMinInputSize',
+                  type_=int,
+                  default=0,
+                  description="If non-zero, reentrant collection producers process input collections of at least this size in parallel chunks.")
+        .setDefault('inputFiles', "root://xrootd-cms.infn.it//store/mc/RunIISummer16MiniAODv3/QCD_Pt_15to30_TuneCUETP8M1_13TeV_pythia8/MINIAODSIM/PUMoriond17_94X_mcRun2_asymptotic_v3-v2/110000/7EEC82AC-41DF-E811-899D-0CC47AF973C2.root")
+        .setDefault('outputFile', "testCollectionProducerTiming_out.root")
+        .setDefault('isData', False)
+        .setDefault('globalTag', "94X_mcRun2_asymptotic_v3")
+        .setDefault('metFiltersProcess', 'PAT')
+        .setDefault('maxEvents', 2000)
+        .setDefault('dumpPython', False)
+        .setDefault('useHLTFilter', False)
+        .setDefault('jsonFilterFile', "")
+        .setDefault('withPATCollections', False)
+        # single thread: module timings are not affected by other streams
+        .setDefault('numThreads', 1)
+).parseArguments()
+
+
+# create the process
+process = KarmaProcess(
+    "KARMASKIM",
+    input_files=options.inputFiles,
+    max_events=options.maxEvents,
+    global_tag=options.globalTag,
+    edm_out=options.outputFile,
+    num_threads=options.numThreads,
+)
+
+# configure the process
+dijetSkim_94X_Run2016_17Jul2018.configure(process, options)
+
+# optional: parallel fill loop for the reentrant producers of large collections
+if options.parallelMinInputSize:
+    for _module_name in ('karmaGenParticles', 'karmaTriggerObjects'):
+        if hasattr(process, _module_name):
+            getattr(process, _module_name).parallelMinInputSize = cms.uint32(options.parallelMinInputSize)
+
+# report the time spent in each module for every event ('TimeModule>' lines)
+process.Timing = cms.Service("Timing",
+    summaryOnly = cms.untracked.bool(False),
+    useJobReport = cms.untracked.bool(False),
+)
+
+# dump expanded cmsRun configuration
+if options.dumpPython:
+    process.dump_python('.'.join(options.outputFile.split('.')[:-1]) + '_dump.py', overwrite=True)
+
+# print out configuration before running
+process.print_configuration()
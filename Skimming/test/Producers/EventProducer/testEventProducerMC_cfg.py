@@ -0,0 +1,72 @@
+import FWCore.ParameterSet.Config as cms
+
+from Karma.Common.Tools import KarmaOptions, KarmaProcess
+
+
+# set up and parse command-line options
+options = (
+    KarmaOptions()
+        .setDefault('inputFiles', "root://xrootd-cms.infn.it//store/mc/RunIISummer16MiniAODv3/QCD_Pt_15to30_TuneCUETP8M1_13TeV_pythia8/MINIAODSIM/PUMoriond17_94X_mcRun2_asymptotic_v3-v2/110000/7EEC82AC-41DF-E811-899D-0CC47AF973C2.root")
+        .setDefault('outputFile', "testEventProducerMC_out.root")
+        .setDefault('isData', False)
+        .setDefault('globalTag', "94X_mcRun2_asymptotic_v3")
+        .setDefault('maxEvents', 1000)
+        .setDefault('dumpPython', True)
+        .setDefault('numThreads', 4)
+).parseArguments()
+
+
+# create the process
+process = KarmaProcess(
+    "KARMASKIM",
+    input_files=options.inputFiles,
+    max_events=options.maxEvents,
+    global_tag=options.globalTag,
+    edm_out=options.outputFile,
+    num_threads=options.numThreads,
+)
+
+process.enable_verbose_logging()  # for testing
+
+# -- configure CMSSW modules
+
+process.add_path('path')
+
+from PhysicsTools.SelectorUtils.pvSelector_cfi import pvSelector
+
+process.add_module(
+    'goodOfflinePrimaryVertices',
+    cms.EDFilter(
+        'PrimaryVertexObjectFilter',
+        src = cms.InputTag("offlineSlimmedPrimaryVertices"),
+        filterParams = pvSelector.clone(
+            maxZ = 24.0
+        ),  # ndof >= 4, rho <= 2
+    ),
+    on_path='path',
+    write_out=False,
+)
+
+from Karma.Skimming.EventProducer_cfi import karmaEventProducer
+
+process.add_module(
+    'karmaEvents',
+    karmaEventProducer(isData=options.isData).clone(
+        hltRegexes = cms.vstring("HLT_(AK8)?PFJet[0-9]+_v[0-9]+", "HLT_DiPFJetAve[0-9]+_v[0-9]+"),
+        metFiltersSrc = cms.InputTag("TriggerResults", "", "PAT"),
+        # the HLT prescale set is usually not available in MC: the prescales
+        # are then written out per event (`triggerPrescaleSet` is -1) and a
+        # warning is issued once per run and stream
+        writeOutTriggerPrescales = cms.bool(True),
+        verifyCachedTriggerPrescales = cms.bool(True),
+    ),
+    on_path='path',
+    write_out=True,
+)
+
+# dump expanded cmsRun configuration
+if options.dumpPython:
+    process.dump_python('.'.join(options.outputFile.split('.')[:-1]) + '_dump.py', overwrite=True)
+
+# print out configuration before running
+process.print_configuration()
@@ -1,29 +1,72 @@
-from Karma.Common.Tools import KarmaOptions, KarmaProcess
+import FWCore.ParameterSet.Config as cms
 
+from Karma.Common.Tools import KarmaOptions, KarmaProcess
 
-# -- override CLI options for test
-options.inputFiles="file://{}".format(os.path.realpath("../../../data/test_JetHT2016G.root"))
-options.isData=1
-options.globalTag="80X_dataRun2_2016LegacyRepro_v4"
-options.edmOut="testEventProducer_out.root"
-options.maxEvents=1000
-options.dumpPython=1
 
+# set up and parse command-line options
+options = (
+    KarmaOptions()
+        .setDefault('inputFiles', "root://xrootd-cms.infn.it//store/data/Run2016G/JetHT/MINIAOD/17Jul2018-v1/60000/06E6B214-5D91-E811-A1AF-0025905C2CBE.root")
+        .setDefault('outputFile', "testEventProducer_out.root")
+        .setDefault('isData', True)
+        .setDefault('globalTag', "94X_dataRun2_v10")
+        .setDefault('maxEvents', 1000)
+        .setDefault('dumpPython', True)
+        # several streams: each one caches the prescales for the lumi sections it processes
+        .setDefault('numThreads', 4)
+).parseArguments()
 
-# -- must be called at the beginning
-process = createProcess("DIJET", num_threads=1)
 
+# create the process
+process = KarmaProcess(
+    "KARMASKIM",
+    input_files=options.inputFiles,
+    max_events=options.maxEvents,
+    global_tag=options.globalTag,
+    edm_out=options.outputFile,
+    num_threads=options.numThreads,
+)
 
-enableVerboseLogging(process)
+process.enable_verbose_logging()  # for testing
 
 # -- configure CMSSW modules
 
-from Karma.Skimming.EventProducer_cfi import karmaEventProducer
+process.add_path('path')
 
-process.dijetEvents = karmaEventProducer
-process.path *= process.dijetEvents
+from PhysicsTools.SelectorUtils.pvSelector_cfi import pvSelector
+
+process.add_module(
+    'goodOfflinePrimaryVertices',
+    cms.EDFilter(
+        'PrimaryVertexObjectFilter',
+        src = cms.InputTag("offlineSlimmedPrimaryVertices"),
+        filterParams = pvSelector.clone(
+            maxZ = 24.0
+        ),  # ndof >= 4, rho <= 2
+    ),
+    on_path='path',
+    write_out=False,
+)
+
+from Karma.Skimming.EventProducer_cfi import karmaEventProducer
 
+process.add_module(
+    'karmaEvents',
+    karmaEventProducer(isData=options.isData).clone(
+        hltRegexes = cms.vstring("HLT_(AK8)?PFJet[0-9]+_v[0-9]+", "HLT_DiPFJetAve[0-9]+_v[0-9]+"),
+        metFiltersSrc = cms.InputTag("TriggerResults", "", "DQM"),
+        writeOutTriggerPrescales = cms.bool(True),
+        # recompute the prescales for every event and check them against
+        # the column cached for its HLT prescale set (throws on mismatch)
+        verifyCachedTriggerPrescales = cms.bool(True),
+    ),
+    on_path='path',
+    write_out=True,
+)
 
-# -- must be called at the end
-finalizeAndRun(process, outputCommands=['keep *_*_*_DIJET'])
+# dump expanded cmsRun configuration
+if options.dumpPython:
+    process.dump_python('.'.join(options.outputFile.split('.')[:-1]) + '_dump.py', overwrite=True)
 
+# print out configuration before running
+process.print_configuration()
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <vector>
+
+#include "Defaults.h"
+#include "Event.h"
+
+
+namespace karma {
+
+    /**
+     * Compact variants of the skim data formats, intended for reducing the
+     * size of the skims. Kinematic quantities are stored in single precision
+     * (`float`), and some low-precision quantities (jet area, energy
+     * fractions) are additionally written out with a truncated mantissa,
+     * as configured per field with `iotype="Float16_t"` in `classes_def.xml`.
+     *
+     * The compact formats are storage formats only: they should be converted
+     * back to the regular formats (see `fromCompact()`) directly after reading,
+     * so that all downstream code keeps operating on double-precision values.
+     * Transient maps are not stored.
+     */
+
+    /**
+     * Compact Lorentz vector class (see `karma::LV`)
+     */
+    class CompactLV {
+      public:
+
+        // -- kinematics
+        float pt = UNDEFINED_DOUBLE;
+        float eta = UNDEFINED_DOUBLE;
+        float phi = UNDEFINED_DOUBLE;
+        float mass = UNDEFINED_DOUBLE;
+
+    };
+    typedef std::vector<karma::CompactLV> CompactLVCollection;
+
+    /**
+     * Compact jet class (see `karma::Jet`)
+     */
+    class CompactJet : public karma::CompactLV {
+      public:
+        float uncorPt = UNDEFINED_DOUBLE;
+        float uncorEta = UNDEFINED_DOUBLE;
+        float uncorPhi = UNDEFINED_DOUBLE;
+        float uncorMass = UNDEFINED_DOUBLE;
+
+        float area = UNDEFINED_DOUBLE;
+
+        int nConstituents = -1;
+        int nCharged = -1;
+        int nElectrons = -1;
+        int nMuons = -1;
+        int nPhotons = -1;
+
+        int hadronFlavor = -999;
+        int partonFlavor = -999;
+
+        float neutralHadronFraction = UNDEFINED_DOUBLE;
+        float chargedHadronFraction = UNDEFINED_DOUBLE;
+        float chargedEMFraction = UNDEFINED_DOUBLE;
+        float neutralEMFraction = UNDEFINED_DOUBLE;
+        float muonFraction = UNDEFINED_DOUBLE;
+        float electronFraction = UNDEFINED_DOUBLE;
+        float photonFraction = UNDEFINED_DOUBLE;
+        float hfHadronFraction = UNDEFINED_DOUBLE;
+        float hfEMFraction = UNDEFINED_DOUBLE;
+
+    };
+    typedef std::vector<karma::CompactJet> CompactJetCollection;
+
+    // -- conversion from the regular formats (write side)
+
+    inline void toCompact(const karma::LorentzVector& in, float& pt, float& eta, float& phi, float& mass) {
+        pt = in.pt();
+        eta = in.eta();
+        phi = in.phi();
+        mass = in.mass();
+    }
+
+    inline void toCompact(const karma::LV& in, karma::CompactLV& out) {
+        toCompact(in.p4, out.pt, out.eta, out.phi, out.mass);
+    }
+
+    inline void toCompact(const karma::Jet& in, karma::CompactJet& out) {
+        toCompact(in.p4, out.pt, out.eta, out.phi, out.mass);
+        toCompact(in.uncorP4, out.uncorPt, out.uncorEta, out.uncorPhi, out.uncorMass);
+
+        out.area = in.area;
+
+        out.nConstituents = in.nConstituents;
+        out.nCharged = in.nCharged;
+        out.nElectrons = in.nElectrons;
+        out.nMuons = in.nMuons;
+        out.nPhotons = in.nPhotons;
+
+        out.hadronFlavor = in.hadronFlavor;
+        out.partonFlavor = in.partonFlavor;
+
+        out.neutralHadronFraction = in.neutralHadronFraction;
+        out.chargedHadronFraction = in.chargedHadronFraction;
+        out.chargedEMFraction = in.chargedEMFraction;
+        out.neutralEMFraction = in.neutralEMFraction;
+        out.muonFraction = in.muonFraction;
+        out.electronFraction = in.electronFraction;
+        out.photonFraction = in.photonFraction;
+        out.hfHadronFraction = in.hfHadronFraction;
+        out.hfEMFraction = in.hfEMFraction;
+    }
+
+    // -- conversion to the regular formats (read side)
+
+    inline karma::LorentzVector fromCompact(float pt, float eta, float phi, float mass) {
+        return karma::LorentzVector(pt, eta, phi, mass);
+    }
+
+    inline void fromCompact(const karma::CompactLV& in, karma::LV& out) {
+        out.p4 = fromCompact(in.pt, in.eta, in.phi, in.mass);
+    }
+
+    inline void fromCompact(const karma::CompactJet& in, karma::Jet& out) {
+        out.p4 = fromCompact(in.pt, in.eta, in.phi, in.mass);
+        out.uncorP4 = fromCompact(in.uncorPt, in.uncorEta, in.uncorPhi, in.uncorMass);
+
+        out.area = in.area;
+
+        out.nConstituents = in.nConstituents;
+        out.nCharged = in.nCharged;
+        out.nElectrons = in.nElectrons;
+        out.nMuons = in.nMuons;
+        out.nPhotons = in.nPhotons;
+
+        out.hadronFlavor = in.hadronFlavor;
+        out.partonFlavor = in.partonFlavor;
+
+        out.neutralHadronFraction = in.neutralHadronFraction;
+        out.chargedHadronFraction = in.chargedHadronFraction;
+        out.chargedEMFraction = in.chargedEMFraction;
+        out.neutralEMFraction = in.neutralEMFraction;
+        out.muonFraction = in.muonFraction;
+        out.electronFraction = in.electronFraction;
+        out.photonFraction = in.photonFraction;
+        out.hfHadronFraction = in.hfHadronFraction;
+        out.hfEMFraction = in.hfEMFraction;
+    }
+
+}  // end namespace
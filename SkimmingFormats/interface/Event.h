@@ -2,11 +2,15 @@
 
 #include <vector>
 #include <algorithm>
+#include <bitset>
+#include <cstdint>
 #include <functional>
 
 #include <boost/algorithm/string/join.hpp>
 
 #include "Defaults.h"
+#include "Run.h"
+#include "TransientMap.h"
 
 // some tools from the EDM data formats
 #include "DataFormats/METReco/interface/CorrMETData.h"
@@ -35,7 +39,14 @@ namespace karma {
         // -- met filter bits
         std::vector<bool> metFilterBits;
 
-        // it's easier to store these once per event rather than once per lumi-section
+        // -- trigger prescales
+        // index of the HLT prescale set active for this event, used to look up the
+        // prescales in the table stored once per lumi-section
+        // (`karma::Lumi::findTriggerPrescaleColumn`), or -1 if not available
+        int triggerPrescaleSet = -1;
+
+        // per-event prescales: only filled if the HLT prescale set cannot be
+        // determined (e.g. MC), and in older skims
         std::vector<int> triggerPathHLTPrescales;
         std::vector<int> triggerPathL1Prescales;
         // define if ever needed
@@ -78,10 +89,11 @@ namespace karma {
         karma::LorentzVector p4;
 
         // transient maps for temporarily storing data while processing
-        std::map<std::string, double> transientDoubles_;
-        std::map<std::string, bool> transientBools_;
-        std::map<std::string, int> transientInts_;
-        std::map<std::string, karma::LorentzVector> transientLVs_;
+        // (keys should be resolved once as `karma::TransientKey`s, see `TransientMap.h`)
+        karma::TransientMap<double> transientDoubles_;
+        karma::TransientMap<bool> transientBools_;
+        karma::TransientMap<int> transientInts_;
+        karma::TransientMap<karma::LorentzVector> transientLVs_;
 
         size_t ptHash() {
             return std::hash<double>()(p4.pt());
@@ -185,6 +197,39 @@ namespace karma {
         double ecalTrkEnergyPreCorr = UNDEFINED_DOUBLE;
         double ecalTrkEnergyPostCorr = UNDEFINED_DOUBLE;
 
+        // -- packed electron ID decisions: bit `8 * i + j` is set if the electron passes
+        //    working point `j` of ID `i` (both in the order configured in the producer)
+        uint32_t idBits = 0;
+
+        static constexpr unsigned int MAX_IDS = 4;
+        static constexpr unsigned int MAX_WORKING_POINTS_PER_ID = 8;
+
+        /** Bit mask for working point `workingPointIndex` of ID `idIndex` */
+        static uint32_t idMask(unsigned int idIndex, unsigned int workingPointIndex) {
+            return uint32_t(1) << (MAX_WORKING_POINTS_PER_ID * idIndex + workingPointIndex);
+        };
+
+        /** True if the electron passes working point `workingPointIndex` of ID `idIndex` */
+        bool passesId(unsigned int idIndex, unsigned int workingPointIndex) const {
+            return idBits & idMask(idIndex, workingPointIndex);
+        };
+
+        /**
+         * True if the electron passes working point `workingPointName` of ID `idName`,
+         * as listed in `idSpecs` (the `karma::ElectronIdSpecs` run product of the electron
+         * producer). For many electrons, resolve the indices once with
+         * `karma::ElectronIdSpecs::getIndices()` instead.
+         */
+        bool passesId(const karma::ElectronIdSpecs& idSpecs, const std::string& idName, const std::string& workingPointName) const {
+            const auto& indices = idSpecs.getIndices(idName, workingPointName);
+            return passesId(indices.first, indices.second);
+        };
+
+        /** Number of working points of ID `idIndex` passed by the electron */
+        int idLevel(unsigned int idIndex) const {
+            return std::bitset<MAX_WORKING_POINTS_PER_ID>(idBits >> (MAX_WORKING_POINTS_PER_ID * idIndex)).count();
+        };
+
     };
     typedef std::vector<karma::Electron> ElectronCollection;
 
@@ -261,6 +306,47 @@ namespace karma {
         std::vector<int> assignedPathIndices;
         std::vector<std::string> filterNames;
 
+        // -- packed representations of `types` and `assignedPathIndices` (see `packFlags()`)
+        uint32_t typeFlags = 0;        // combination of `TypeFlag`s
+        std::vector<uint64_t> pathBits;  // bit `i % 64` of word `i / 64` is set if assigned to path with index `i`
+
+        enum TypeFlag : uint32_t {
+            TYPE_FLAGS_FILLED = 1u << 0,  // packed representations have been filled
+            TYPE_FLAG_ZERO = 1u << 1,     // at least one type is zero
+            TYPE_FLAG_HLT = 1u << 2,      // at least one type is positive (HLT object types)
+            TYPE_FLAG_L1 = 1u << 3,       // at least one type is negative (L1 object types)
+        };
+
+        /**
+         * Fill the packed representations `typeFlags` and `pathBits` from
+         * `types` and `assignedPathIndices`. `numPaths` is the number of
+         * trigger paths in the run and determines the width of `pathBits`.
+         */
+        void packFlags(size_t numPaths) {
+            typeFlags = TYPE_FLAGS_FILLED;
+            for (const auto& type : types) {
+                typeFlags |= (type > 0) ? TYPE_FLAG_HLT : ((type < 0) ? TYPE_FLAG_L1 : TYPE_FLAG_ZERO);
+            }
+            pathBits.assign((numPaths + 63) / 64, 0);
+            for (const auto& pathIndex : assignedPathIndices) {
+                if ((pathIndex >= 0) && (static_cast<size_t>(pathIndex) < numPaths)) {
+                    pathBits[pathIndex / 64] |= (uint64_t(1) << (pathIndex % 64));
+                }
+            }
+        };
+
+        /** True if assigned to the trigger path with index `pathIndex` */
+        bool isAssignedToPath(int pathIndex) const {
+            // fall back to the path index vector for objects without packed flags
+            if (!(typeFlags & TYPE_FLAGS_FILLED)) {
+                return std::find(assignedPathIndices.cbegin(), assignedPathIndices.cend(), pathIndex) != assignedPathIndices.cend();
+            }
+            if ((pathIndex < 0) || (static_cast<size_t>(pathIndex / 64) >= pathBits.size())) {
+                return false;
+            }
+            return pathBits[pathIndex / 64] & (uint64_t(1) << (pathIndex % 64));
+        };
+
         size_t numFilters() const { return filterNames.size(); };
 
         std::string filterString() const {
@@ -279,6 +365,9 @@ namespace karma {
         };
 
         bool isL1() const {
+            if (typeFlags & TYPE_FLAGS_FILLED) {
+                return !(typeFlags & TYPE_FLAG_HLT);
+            }
             if (std::all_of(types.cbegin(), types.cend(), [](int i){ return i <= 0; })) {
                 return true;
             }
@@ -287,6 +376,9 @@ namespace karma {
         }
 
         bool isHLT() const {
+            if (typeFlags & TYPE_FLAGS_FILLED) {
+                return !(typeFlags & TYPE_FLAG_L1);
+            }
             if (std::all_of(types.cbegin(), types.cend(), [](int i){ return i >= 0; })) {
                 return true;
             }
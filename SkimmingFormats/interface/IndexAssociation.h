@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+
+#include "DataFormats/Provenance/interface/ProductID.h"
+
+namespace karma {
+
+    /**
+     * Compact association between the elements of a primary and a secondary
+     * collection, stored as plain indices in compressed sparse row (CSR) layout:
+     *
+     *   - the secondary indices associated to primary `i` are stored in
+     *     `secondaryIndices[offsets[i]]` to `secondaryIndices[offsets[i+1] - 1]`
+     *   - `metricValues` holds the value of the matching metric for each entry
+     *     of `secondaryIndices`
+     *
+     * Unlike `edm::AssociationMap`, lookups by primary index are O(1) and
+     * do not require constructing `edm::Ref`s. The indices refer to the
+     * collections which were used for producing the association, identified
+     * by `primaryProductId` and `secondaryProductId`.
+     */
+    class IndexAssociation {
+      public:
+        // -- product IDs of the associated collections
+        edm::ProductID primaryProductId;
+        edm::ProductID secondaryProductId;
+
+        // -- CSR storage
+        std::vector<unsigned int> offsets;           // size: number of primaries + 1
+        std::vector<unsigned int> secondaryIndices;  // size: number of associations
+        std::vector<double> metricValues;            // size: number of associations
+
+        // -- accessors
+
+        size_t numPrimaries() const { return offsets.empty() ? 0 : offsets.size() - 1; };
+        size_t numAssociations() const { return secondaryIndices.size(); };
+
+        /** Number of secondaries associated to primary with index `primaryIndex` */
+        size_t numAssociations(size_t primaryIndex) const {
+            return (primaryIndex < numPrimaries()) ? offsets[primaryIndex + 1] - offsets[primaryIndex] : 0;
+        };
+
+        /** True if at least one secondary is associated to primary with index `primaryIndex` */
+        bool hasAssociation(size_t primaryIndex) const { return numAssociations(primaryIndex) > 0; };
+
+        /** Indices of the secondaries associated to primary with index `primaryIndex` (as [begin, end) pointers) */
+        std::pair<const unsigned int*, const unsigned int*> secondaryIndicesFor(size_t primaryIndex) const {
+            if (!hasAssociation(primaryIndex)) return {nullptr, nullptr};
+            return {secondaryIndices.data() + offsets[primaryIndex], secondaryIndices.data() + offsets[primaryIndex + 1]};
+        };
+
+        /** Metric values for the secondaries associated to primary with index `primaryIndex` (as [begin, end) pointers) */
+        std::pair<const double*, const double*> metricValuesFor(size_t primaryIndex) const {
+            if (!hasAssociation(primaryIndex)) return {nullptr, nullptr};
+            return {metricValues.data() + offsets[primaryIndex], metricValues.data() + offsets[primaryIndex + 1]};
+        };
+
+        /** Index of the first secondary associated to primary `primaryIndex`, or -1 if there is none */
+        int firstSecondaryIndex(size_t primaryIndex) const {
+            return hasAssociation(primaryIndex) ? static_cast<int>(secondaryIndices[offsets[primaryIndex]]) : -1;
+        };
+
+        // -- filling
+
+        /**
+         * Fill from a list of matched (primary, secondary) index pairs and the
+         * corresponding metric values, together with the product IDs of the
+         * primary and secondary collections. Pairs are grouped by primary index;
+         * the relative order of the pairs of each primary is preserved.
+         */
+        void fill(const edm::ProductID& primaryId, const edm::ProductID& secondaryId, size_t nPrimaries,
+                  const std::vector<std::pair<int, int>>& matchedIndexPairs, const std::vector<double>& matchedMetricValues) {
+            primaryProductId = primaryId;
+            secondaryProductId = secondaryId;
+
+            // -- count associations per primary
+            offsets.assign(nPrimaries + 1, 0);
+            for (const auto& matchedIndexPair : matchedIndexPairs) {
+                ++offsets[matchedIndexPair.first + 1];
+            }
+            for (size_t iPrimary = 0; iPrimary < nPrimaries; ++iPrimary) {
+                offsets[iPrimary + 1] += offsets[iPrimary];
+            }
+
+            // -- place the pairs (stable counting sort by primary index)
+            secondaryIndices.resize(matchedIndexPairs.size());
+            metricValues.resize(matchedIndexPairs.size());
+            std::vector<unsigned int> nextPositions(offsets.begin(), offsets.end() - 1);
+            for (size_t iPair = 0; iPair < matchedIndexPairs.size(); ++iPair) {
+                const unsigned int position = nextPositions[matchedIndexPairs[iPair].first]++;
+                secondaryIndices[position] = matchedIndexPairs[iPair].second;
+                metricValues[position] = matchedMetricValues[iPair];
+            }
+        };
+
+    };
+    typedef std::vector<karma::IndexAssociation> IndexAssociationCollection;
+}
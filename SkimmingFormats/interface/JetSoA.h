@@ -0,0 +1,282 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Defaults.h"
+#include "Event.h"
+
+
+namespace karma {
+
+    class JetSoACollection;
+
+    /**
+     * Lightweight read-only proxy for one jet of a `karma::JetSoACollection`,
+     * providing the data members of `karma::Jet` as accessor functions.
+     * Only the columns which are actually accessed are touched.
+     */
+    class JetSoAProxy {
+      public:
+        JetSoAProxy(const karma::JetSoACollection& collection, size_t index) : collection_(&collection), index_(index) {};
+
+        // -- kinematics
+        double pt() const;
+        double eta() const;
+        double phi() const;
+        double mass() const;
+        karma::LorentzVector p4() const;
+        karma::LorentzVector uncorP4() const;
+
+        double area() const;
+
+        int nConstituents() const;
+        int nCharged() const;
+        int nElectrons() const;
+        int nMuons() const;
+        int nPhotons() const;
+
+        int hadronFlavor() const;
+        int partonFlavor() const;
+
+        double neutralHadronFraction() const;
+        double chargedHadronFraction() const;
+        double chargedEMFraction() const;
+        double neutralEMFraction() const;
+        double muonFraction() const;
+        double electronFraction() const;
+        double photonFraction() const;
+        double hfHadronFraction() const;
+        double hfEMFraction() const;
+
+        /** Copy of the jet as a `karma::Jet` (reads all columns) */
+        karma::Jet toJet() const;
+
+        size_t index() const { return index_; };
+
+      private:
+        const karma::JetSoACollection* collection_;
+        size_t index_;
+    };
+
+    /**
+     * Jet collection stored as a structure of arrays (one vector per data
+     * member of `karma::Jet`). When written out in split mode, each column
+     * is stored in a separate ROOT branch, so that e.g. a fast pre-selection
+     * on the kinematics only needs to read the `pt`, `eta` and `phi`
+     * branches. Transient maps are not stored.
+     *
+     * Elements are accessed through `karma::JetSoAProxy` objects. The
+     * collection can be filled directly by a `CollectionProducerBase` (see
+     * `is_struct_of_arrays`).
+     */
+    class JetSoACollection {
+      public:
+        typedef karma::Jet value_type;
+        typedef std::true_type is_struct_of_arrays;
+
+        class const_iterator {
+          public:
+            const_iterator(const karma::JetSoACollection& collection, size_t index) : collection_(&collection), index_(index) {};
+
+            karma::JetSoAProxy operator*() const { return karma::JetSoAProxy(*collection_, index_); };
+            const_iterator& operator++() { ++index_; return *this; };
+            bool operator==(const const_iterator& other) const { return index_ == other.index_; };
+            bool operator!=(const const_iterator& other) const { return index_ != other.index_; };
+
+          private:
+            const karma::JetSoACollection* collection_;
+            size_t index_;
+        };
+
+        // -- columns
+
+        // kinematics
+        std::vector<double> pt;
+        std::vector<double> eta;
+        std::vector<double> phi;
+        std::vector<double> mass;
+        std::vector<double> uncorPt;
+        std::vector<double> uncorEta;
+        std::vector<double> uncorPhi;
+        std::vector<double> uncorMass;
+
+        std::vector<double> area;
+
+        std::vector<int> nConstituents;
+        std::vector<int> nCharged;
+        std::vector<int> nElectrons;
+        std::vector<int> nMuons;
+        std::vector<int> nPhotons;
+
+        std::vector<int> hadronFlavor;
+        std::vector<int> partonFlavor;
+
+        std::vector<double> neutralHadronFraction;
+        std::vector<double> chargedHadronFraction;
+        std::vector<double> chargedEMFraction;
+        std::vector<double> neutralEMFraction;
+        std::vector<double> muonFraction;
+        std::vector<double> electronFraction;
+        std::vector<double> photonFraction;
+        std::vector<double> hfHadronFraction;
+        std::vector<double> hfEMFraction;
+
+        // -- container interface
+
+        size_t size() const { return pt.size(); };
+        bool empty() const { return pt.empty(); };
+
+        karma::JetSoAProxy operator[](size_t index) const { return karma::JetSoAProxy(*this, index); };
+        karma::JetSoAProxy at(size_t index) const {
+            if (index >= size()) {
+                throw std::out_of_range("JetSoACollection::at: index " + std::to_string(index) + " out of range");
+            }
+            return (*this)[index];
+        };
+
+        const_iterator begin() const { return const_iterator(*this, 0); };
+        const_iterator end() const { return const_iterator(*this, size()); };
+
+        /** Append a jet (the transient maps are not stored) */
+        void push_back(const karma::Jet& jet) {
+            pt.push_back(jet.p4.pt());
+            eta.push_back(jet.p4.eta());
+            phi.push_back(jet.p4.phi());
+            mass.push_back(jet.p4.mass());
+            uncorPt.push_back(jet.uncorP4.pt());
+            uncorEta.push_back(jet.uncorP4.eta());
+            uncorPhi.push_back(jet.uncorP4.phi());
+            uncorMass.push_back(jet.uncorP4.mass());
+
+            area.push_back(jet.area);
+
+            nConstituents.push_back(jet.nConstituents);
+            nCharged.push_back(jet.nCharged);
+            nElectrons.push_back(jet.nElectrons);
+            nMuons.push_back(jet.nMuons);
+            nPhotons.push_back(jet.nPhotons);
+
+            hadronFlavor.push_back(jet.hadronFlavor);
+            partonFlavor.push_back(jet.partonFlavor);
+
+            neutralHadronFraction.push_back(jet.neutralHadronFraction);
+            chargedHadronFraction.push_back(jet.chargedHadronFraction);
+            chargedEMFraction.push_back(jet.chargedEMFraction);
+            neutralEMFraction.push_back(jet.neutralEMFraction);
+            muonFraction.push_back(jet.muonFraction);
+            electronFraction.push_back(jet.electronFraction);
+            photonFraction.push_back(jet.photonFraction);
+            hfHadronFraction.push_back(jet.hfHadronFraction);
+            hfEMFraction.push_back(jet.hfEMFraction);
+        };
+
+        void reserve(size_t n) { forEachColumn([n](auto& column) { column.reserve(n); }); };
+        void clear() { forEachColumn([](auto& column) { column.clear(); }); };
+
+        /** Append all jets of another collection */
+        void append(const JetSoACollection& other) {
+            forEachColumnMember([this, &other](auto member) {
+                (this->*member).insert((this->*member).end(), (other.*member).begin(), (other.*member).end());
+            });
+        };
+
+        /** Convert to a regular `karma::JetCollection` (reads all columns) */
+        karma::JetCollection toJetCollection() const {
+            karma::JetCollection jets;
+            jets.reserve(size());
+            for (const auto& jet : *this) {
+                jets.push_back(jet.toJet());
+            }
+            return jets;
+        };
+
+      private:
+        template<typename Function>
+        static void forEachColumnMember(Function&& function) {
+            for (auto column : {&JetSoACollection::pt, &JetSoACollection::eta, &JetSoACollection::phi, &JetSoACollection::mass,
+                                &JetSoACollection::uncorPt, &JetSoACollection::uncorEta, &JetSoACollection::uncorPhi, &JetSoACollection::uncorMass,
+                                &JetSoACollection::area,
+                                &JetSoACollection::neutralHadronFraction, &JetSoACollection::chargedHadronFraction, &JetSoACollection::chargedEMFraction,
+                                &JetSoACollection::neutralEMFraction, &JetSoACollection::muonFraction, &JetSoACollection::electronFraction,
+                                &JetSoACollection::photonFraction, &JetSoACollection::hfHadronFraction, &JetSoACollection::hfEMFraction}) {
+                function(column);
+            }
+            for (auto column : {&JetSoACollection::nConstituents, &JetSoACollection::nCharged, &JetSoACollection::nElectrons,
+                                &JetSoACollection::nMuons, &JetSoACollection::nPhotons,
+                                &JetSoACollection::hadronFlavor, &JetSoACollection::partonFlavor}) {
+                function(column);
+            }
+        };
+
+        template<typename Function>
+        void forEachColumn(Function&& function) {
+            forEachColumnMember([this, &function](auto member) { function(this->*member); });
+        };
+    };
+
+    // -- proxy accessors (defined here, since they need the complete collection type)
+
+    inline double JetSoAProxy::pt() const { return collection_->pt[index_]; }
+    inline double JetSoAProxy::eta() const { return collection_->eta[index_]; }
+    inline double JetSoAProxy::phi() const { return collection_->phi[index_]; }
+    inline double JetSoAProxy::mass() const { return collection_->mass[index_]; }
+    inline karma::LorentzVector JetSoAProxy::p4() const {
+        return karma::LorentzVector(collection_->pt[index_], collection_->eta[index_], collection_->phi[index_], collection_->mass[index_]);
+    }
+    inline karma::LorentzVector JetSoAProxy::uncorP4() const {
+        return karma::LorentzVector(collection_->uncorPt[index_], collection_->uncorEta[index_], collection_->uncorPhi[index_], collection_->uncorMass[index_]);
+    }
+
+    inline double JetSoAProxy::area() const { return collection_->area[index_]; }
+
+    inline int JetSoAProxy::nConstituents() const { return collection_->nConstituents[index_]; }
+    inline int JetSoAProxy::nCharged() const { return collection_->nCharged[index_]; }
+    inline int JetSoAProxy::nElectrons() const { return collection_->nElectrons[index_]; }
+    inline int JetSoAProxy::nMuons() const { return collection_->nMuons[index_]; }
+    inline int JetSoAProxy::nPhotons() const { return collection_->nPhotons[index_]; }
+
+    inline int JetSoAProxy::hadronFlavor() const { return collection_->hadronFlavor[index_]; }
+    inline int JetSoAProxy::partonFlavor() const { return collection_->partonFlavor[index_]; }
+
+    inline double JetSoAProxy::neutralHadronFraction() const { return collection_->neutralHadronFraction[index_]; }
+    inline double JetSoAProxy::chargedHadronFraction() const { return collection_->chargedHadronFraction[index_]; }
+    inline double JetSoAProxy::chargedEMFraction() const { return collection_->chargedEMFraction[index_]; }
+    inline double JetSoAProxy::neutralEMFraction() const { return collection_->neutralEMFraction[index_]; }
+    inline double JetSoAProxy::muonFraction() const { return collection_->muonFraction[index_]; }
+    inline double JetSoAProxy::electronFraction() const { return collection_->electronFraction[index_]; }
+    inline double JetSoAProxy::photonFraction() const { return collection_->photonFraction[index_]; }
+    inline double JetSoAProxy::hfHadronFraction() const { return collection_->hfHadronFraction[index_]; }
+    inline double JetSoAProxy::hfEMFraction() const { return collection_->hfEMFraction[index_]; }
+
+    inline karma::Jet JetSoAProxy::toJet() const {
+        karma::Jet jet;
+        jet.p4 = p4();
+        jet.uncorP4 = uncorP4();
+
+        jet.area = area();
+
+        jet.nConstituents = nConstituents();
+        jet.nCharged = nCharged();
+        jet.nElectrons = nElectrons();
+        jet.nMuons = nMuons();
+        jet.nPhotons = nPhotons();
+
+        jet.hadronFlavor = hadronFlavor();
+        jet.partonFlavor = partonFlavor();
+
+        jet.neutralHadronFraction = neutralHadronFraction();
+        jet.chargedHadronFraction = chargedHadronFraction();
+        jet.chargedEMFraction = chargedEMFraction();
+        jet.neutralEMFraction = neutralEMFraction();
+        jet.muonFraction = muonFraction();
+        jet.electronFraction = electronFraction();
+        jet.photonFraction = photonFraction();
+        jet.hfHadronFraction = hfHadronFraction();
+        jet.hfEMFraction = hfEMFraction();
+        return jet;
+    }
+
+}  // end namespace
@@ -1,16 +1,88 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
 #include "Defaults.h"
 
 namespace karma {
+    /**
+     * One column of trigger path prescales, i.e. the HLT and L1 prescales
+     * of all selected trigger paths (same order as `karma::Run::triggerPathInfos`),
+     * keyed by the index of the HLT prescale set they were obtained for
+     */
+    struct TriggerPrescaleColumn {
+        int prescaleSet = -1;
+        std::vector<int> hltPrescales;
+        std::vector<int> l1Prescales;
+
+        bool operator==(const TriggerPrescaleColumn& other) const {
+            return (prescaleSet == other.prescaleSet) && (hltPrescales == other.hltPrescales) && (l1Prescales == other.l1Prescales);
+        };
+    };
+    typedef std::vector<karma::TriggerPrescaleColumn> TriggerPrescaleColumns;
+
+
     class Lumi {
       public:
         // -- Lumi metadata
         long run = -1;
         int lumi = -1;
 
+        // -- table of trigger prescale columns seen in this luminosity block,
+        //    sorted by HLT prescale set index (referenced by `karma::Event::triggerPrescaleSet`)
+        TriggerPrescaleColumns triggerPrescaleColumns;
+
+        /**
+         * Return the prescale column for HLT prescale set `prescaleSet`,
+         * or `nullptr` if there is none in the table.
+         */
+        const TriggerPrescaleColumn* findTriggerPrescaleColumn(int prescaleSet) const {
+            const auto& it = lowerBound(prescaleSet);
+            if ((it != triggerPrescaleColumns.end()) && (it->prescaleSet == prescaleSet)) {
+                return &(*it);
+            }
+            return nullptr;
+        };
+
+        /**
+         * Add `column` to the prescale table if there is no column for its
+         * prescale set yet. Return the column stored for that prescale set.
+         */
+        const TriggerPrescaleColumn& addTriggerPrescaleColumn(const TriggerPrescaleColumn& column) {
+            auto it = lowerBound(column.prescaleSet);
+            if ((it == triggerPrescaleColumns.end()) || (it->prescaleSet != column.prescaleSet)) {
+                it = triggerPrescaleColumns.insert(it, column);
+            }
+            return *it;
+        };
+
+        /**
+         * Merge the luminosity block fragment `other` (e.g. from another skim
+         * file) into this one. Called by the framework when merging products.
+         */
+        bool mergeProduct(const Lumi& other) {
+            if ((run != other.run) || (lumi != other.lumi))
+                return false;
+            for (const auto& column : other.triggerPrescaleColumns) {
+                if (!(addTriggerPrescaleColumn(column) == column))
+                    return false;
+            }
+            return true;
+        };
+
+      private:
+        TriggerPrescaleColumns::iterator lowerBound(int prescaleSet) {
+            return std::lower_bound(
+                triggerPrescaleColumns.begin(), triggerPrescaleColumns.end(), prescaleSet,
+                [](const TriggerPrescaleColumn& column, int key) { return column.prescaleSet < key; });
+        };
+        TriggerPrescaleColumns::const_iterator lowerBound(int prescaleSet) const {
+            return std::lower_bound(
+                triggerPrescaleColumns.begin(), triggerPrescaleColumns.end(), prescaleSet,
+                [](const TriggerPrescaleColumn& column, int key) { return column.prescaleSet < key; });
+        };
+
     };
 
     typedef std::vector<karma::Lumi> LumiCollection;
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "Defaults.h"
@@ -41,4 +45,34 @@ namespace karma {
     };
     typedef std::vector<karma::Run> RunCollection;
 
+    /**
+     * Names of the electron IDs and their working points (from loose to tight),
+     * in the order in which their decisions are packed into `karma::Electron::idBits`.
+     * Written out once per run by the electron producer.
+     */
+    class ElectronIdSpecs {
+      public:
+        std::vector<std::string> idNames;
+        std::vector<std::vector<std::string>> workingPointNames;  // one list per ID
+
+        /**
+         * Return the indices of ID `idName` and of its working point `workingPointName`,
+         * for use with `karma::Electron::passesId(idIndex, workingPointIndex)`.
+         * Throws if the ID or working point is not available.
+         */
+        std::pair<unsigned int, unsigned int> getIndices(const std::string& idName, const std::string& workingPointName) const {
+            const auto& itId = std::find(idNames.begin(), idNames.end(), idName);
+            if (itId == idNames.end()) {
+                throw std::out_of_range("Electron Id '" + idName + "' was not written out!");
+            }
+            const unsigned int idIndex = std::distance(idNames.begin(), itId);
+
+            const auto& itWorkingPoint = std::find(workingPointNames[idIndex].begin(), workingPointNames[idIndex].end(), workingPointName);
+            if (itWorkingPoint == workingPointNames[idIndex].end()) {
+                throw std::out_of_range("Working point '" + workingPointName + "' of electron Id '" + idName + "' was not written out!");
+            }
+            return std::make_pair(idIndex, static_cast<unsigned int>(std::distance(workingPointNames[idIndex].begin(), itWorkingPoint)));
+        };
+    };
+
 }
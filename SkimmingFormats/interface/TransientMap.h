@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace karma {
+
+    /**
+     * Process-wide registry assigning a small integer id to each key used
+     * in the transient maps of the data formats. Ids are assigned on first
+     * use and never change, so they can be resolved once (e.g. in a module
+     * constructor) and used for all subsequent lookups. Thread-safe.
+     */
+    class TransientKeyRegistry {
+      public:
+        static TransientKeyRegistry& instance();
+
+        /** Id for key `name` (assigned if not yet registered) */
+        unsigned int getOrRegisterId(const std::string& name);
+
+        /** Id for key `name`, or `INVALID_ID` if not registered (does not register the key) */
+        unsigned int findId(const std::string& name) const;
+
+        /** Name of key with id `id` */
+        const std::string& getName(unsigned int id) const;
+
+        static constexpr unsigned int INVALID_ID = static_cast<unsigned int>(-1);
+
+      private:
+        TransientKeyRegistry() {};
+
+        mutable std::mutex mutex_;
+        std::unordered_map<std::string, unsigned int> ids_;
+        std::deque<std::string> names_;  // indexed by id (references stay valid on insertion)
+    };
+
+    /**
+     * Interned key for the transient maps. Construction from a string
+     * involves a registry lookup, so keys should be created once and
+     * reused, e.g. as module members.
+     */
+    class TransientKey {
+      public:
+        TransientKey() : id_(TransientKeyRegistry::INVALID_ID) {};
+        explicit TransientKey(const std::string& name) : id_(TransientKeyRegistry::instance().getOrRegisterId(name)) {};
+
+        unsigned int id() const { return id_; };
+        const std::string& name() const { return TransientKeyRegistry::instance().getName(id_); };
+
+        bool operator==(const TransientKey& other) const { return id_ == other.id_; };
+        bool operator!=(const TransientKey& other) const { return id_ != other.id_; };
+
+      private:
+        unsigned int id_;
+    };
+
+    /**
+     * Small map from `TransientKey` to values of type `T`, stored as a flat
+     * vector of (key id, value) pairs sorted by key id. Copying an object
+     * with transient maps copies one contiguous buffer per map, and lookups
+     * do not involve any string comparisons.
+     *
+     * String-based accessors are provided for compatibility. These resolve
+     * the key in the registry on every call and should be avoided in loops.
+     */
+    template <typename T>
+    class TransientMap {
+      public:
+        typedef std::pair<unsigned int, T> value_type;
+        typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+        // -- access by key
+
+        /** Value for `key` (inserted with default value if not present) */
+        T& operator[](const TransientKey& key) {
+            auto it = lowerBound(key.id());
+            if ((it == entries_.end()) || (it->first != key.id())) {
+                it = entries_.emplace(it, key.id(), T());
+            }
+            return it->second;
+        };
+
+        /** Value for `key` (throws `std::out_of_range` if not present) */
+        const T& at(const TransientKey& key) const {
+            const auto it = find(key.id());
+            if (it == entries_.end()) {
+                throw std::out_of_range("TransientMap::at: key '" + keyName(key.id()) + "' not found");
+            }
+            return it->second;
+        };
+        T& at(const TransientKey& key) {
+            return const_cast<T&>(static_cast<const TransientMap&>(*this).at(key));
+        };
+
+        size_t count(const TransientKey& key) const { return (find(key.id()) != entries_.end()) ? 1 : 0; };
+
+        /** Pointer to value for `key`, or `nullptr` if not present */
+        const T* get(const TransientKey& key) const {
+            const auto it = find(key.id());
+            return (it != entries_.end()) ? &it->second : nullptr;
+        };
+
+        // -- access by name (compatibility)
+
+        T& operator[](const std::string& name) { return (*this)[TransientKey(name)]; };
+
+        const T& at(const std::string& name) const {
+            const auto it = find(TransientKeyRegistry::instance().findId(name));
+            if (it == entries_.end()) {
+                throw std::out_of_range("TransientMap::at: key '" + name + "' not found");
+            }
+            return it->second;
+        };
+        T& at(const std::string& name) {
+            return const_cast<T&>(static_cast<const TransientMap&>(*this).at(name));
+        };
+
+        size_t count(const std::string& name) const { return (find(TransientKeyRegistry::instance().findId(name)) != entries_.end()) ? 1 : 0; };
+
+        // -- container interface
+
+        size_t size() const { return entries_.size(); };
+        bool empty() const { return entries_.empty(); };
+        void clear() { entries_.clear(); };
+        void reserve(size_t n) { entries_.reserve(n); };
+
+        /** Iteration over (key id, value) pairs, ordered by key id (use `TransientKeyRegistry` to get key names) */
+        const_iterator begin() const { return entries_.begin(); };
+        const_iterator end() const { return entries_.end(); };
+
+      private:
+        typename std::vector<value_type>::iterator lowerBound(unsigned int id) {
+            return std::lower_bound(entries_.begin(), entries_.end(), id, [](const value_type& entry, unsigned int entryId) { return entry.first < entryId; });
+        };
+
+        const_iterator find(unsigned int id) const {
+            const auto it = std::lower_bound(entries_.begin(), entries_.end(), id, [](const value_type& entry, unsigned int entryId) { return entry.first < entryId; });
+            return ((it != entries_.end()) && (it->first == id)) ? it : entries_.end();
+        };
+
+        static std::string keyName(unsigned int id) {
+            return (id == TransientKeyRegistry::INVALID_ID) ? std::string("<invalid>") : TransientKeyRegistry::instance().getName(id);
+        };
+
+        std::vector<value_type> entries_;
+    };
+
+}  // end namespace
@@ -0,0 +1,34 @@
+#include "Karma/SkimmingFormats/interface/TransientMap.h"
+
+
+karma::TransientKeyRegistry& karma::TransientKeyRegistry::instance() {
+    // defined out-of-line, so there is exactly one registry per process
+    static TransientKeyRegistry registry;
+    return registry;
+}
+
+unsigned int karma::TransientKeyRegistry::getOrRegisterId(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    const unsigned int id = names_.size();
+    names_.push_back(name);
+    ids_.emplace(name, id);
+    return id;
+}
+
+unsigned int karma::TransientKeyRegistry::findId(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = ids_.find(name);
+    return (it != ids_.end()) ? it->second : INVALID_ID;
+}
+
+const std::string& karma::TransientKeyRegistry::getName(unsigned int id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id >= names_.size()) {
+        throw std::out_of_range("TransientKeyRegistry: invalid key id " + std::to_string(id));
+    }
+    return names_[id];
+}
@@ -2,8 +2,11 @@
 
 #include "DataFormats/Common/interface/Wrapper.h"
 #include "Karma/SkimmingFormats/interface/Event.h"
+#include "Karma/SkimmingFormats/interface/CompactEvent.h"
+#include "Karma/SkimmingFormats/interface/JetSoA.h"
 #include "Karma/SkimmingFormats/interface/Lumi.h"
 #include "Karma/SkimmingFormats/interface/Run.h"
+#include "Karma/SkimmingFormats/interface/IndexAssociation.h"
 
 #include "DataFormats/Common/interface/ValueMap.h"
 #include "DataFormats/Common/interface/AssociationVector.h"
@@ -30,12 +33,20 @@ namespace {
         karma::LumiCollection dict_karmaLumiCollection;
         edm::Wrapper<karma::LumiCollection> dict_edmWrapperDijetLumiCollection;
 
+        // trigger prescale table
+        karma::TriggerPrescaleColumn dict_karmaTriggerPrescaleColumn;
+        karma::TriggerPrescaleColumns dict_karmaTriggerPrescaleColumns;
+
         // run
         karma::Run dict_karmaRun;
         edm::Wrapper<karma::Run> dict_edmWrapperDijetRun;
         karma::RunCollection dict_karmaRunCollection;
         edm::Wrapper<karma::RunCollection> dict_edmWrapperDijetRunCollection;
 
+        // electron Id names
+        karma::ElectronIdSpecs dict_karmaElectronIdSpecs;
+        edm::Wrapper<karma::ElectronIdSpecs> dict_edmWrapperKarmaElectronIdSpecs;
+
         // HLT infos
         karma::HLTPathInfo dict_karmaHLTPathInfo;
         edm::Wrapper<karma::HLTPathInfo> dict_edmWrapperDijetHLTPathInfo;
@@ -181,6 +192,21 @@ namespace {
         std::pair<edm::Ref<karma::JetCollection>, karma::LorentzVector> dict_karmaAssociationVectorPairJetToLV;
         std::vector<std::pair<edm::Ref<karma::JetCollection>, karma::LorentzVector>> dict_karmaAssociationVectorPairVectorJetToLV;
 
+        // jets (structure of arrays)
+        karma::JetSoACollection dict_karmaJetSoACollection;
+        edm::Wrapper<karma::JetSoACollection> dict_edmWrapperDijetJetSoACollection;
+
+        // compact formats
+        karma::CompactLV dict_karmaCompactLV;
+        edm::Wrapper<karma::CompactLV> dict_edmWrapperDijetCompactLV;
+        karma::CompactLVCollection dict_karmaCompactLVCollection;
+        edm::Wrapper<karma::CompactLVCollection> dict_edmWrapperDijetCompactLVCollection;
+
+        karma::CompactJet dict_karmaCompactJet;
+        edm::Wrapper<karma::CompactJet> dict_edmWrapperDijetCompactJet;
+        karma::CompactJetCollection dict_karmaCompactJetCollection;
+        edm::Wrapper<karma::CompactJetCollection> dict_edmWrapperDijetCompactJetCollection;
+
         // MET
         karma::MET dict_karmaMET;
         edm::Wrapper<karma::MET> dict_edmWrapperDijetMET;
@@ -249,6 +275,12 @@ namespace {
         edm::Wrapper<karma::JetGenJetMaps> dict_edmWrapperDijetJetGenJetMaps;
         edm::helpers::KeyVal<edm::RefProd<vector<karma::Jet> >,edm::RefProd<vector<karma::LV> > > dict_edmKeyValDijetJetToGenJetLV;
 
+        // index-based (CSR) association
+        karma::IndexAssociation dict_karmaIndexAssociation;
+        edm::Wrapper<karma::IndexAssociation> dict_edmWrapperIndexAssociation;
+        karma::IndexAssociationCollection dict_karmaIndexAssociationCollection;
+        edm::Wrapper<karma::IndexAssociationCollection> dict_edmWrapperIndexAssociationCollection;
+
         // value maps to LV
         edm::ValueMap<karma::LorentzVector> dict_karmaLVValueMap;
         edm::Wrapper<edm::ValueMap<karma::LorentzVector>> dict_edmWrapperDijetLVValueMap;
@@ -26,6 +26,7 @@
 #include "Karma/Common/interface/Providers/JetIDProvider.h"
 #include "Karma/Common/interface/Providers/FlexGridBinProvider.h"
 #include "Karma/Common/interface/Providers/PileupWeightProvider.h"
+#include "Karma/Common/interface/Tools/TriggerMenuRegistry.h"
 
 // -- output data formats
 #include "Karma/ZJetAnalysisFormats/interface/Ntuple.h"
@@ -62,8 +63,7 @@ namespace zjet {
 
       public:
         NtupleProducerGlobalCache(const edm::ParameterSet& pSet) :
-            karma::CacheBase(pSet),
-            hltVersionPattern_(boost::regex("(HLT_.*)_v[0-9]+", boost::regex::extended)) {
+            karma::CacheBase(pSet) {
 
             /// // create the global trigger efficiencies provider instance
             /// triggerEfficienciesProvider_ = std::unique_ptr<karma::TriggerEfficienciesProvider>(
@@ -112,7 +112,6 @@ namespace zjet {
 
         };
 
-        const boost::regex hltVersionPattern_;
         std::vector<std::string> hltPaths_;
         std::vector<double> hltThresholds_;
         std::vector<double> l1Thresholds_;
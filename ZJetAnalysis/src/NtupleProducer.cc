@@ -86,31 +86,19 @@ zjet::NtupleProducer::~NtupleProducer() {
     typename edm::Handle<karma::Run> runHandle;
     run.getByLabel(globalCache->pSet_.getParameter<edm::InputTag>("karmaRunSrc"), runHandle);
 
-    // compute the unversioned HLT path names
+    // compute the unversioned HLT path names and their indices in the analysis config
     // (needed later to get the trigger efficiencies)
-
-    runCache->triggerPathsUnversionedNames_.resize(runHandle->triggerPathInfos.size());
-    runCache->triggerPathsIndicesInConfig_.resize(runHandle->triggerPathInfos.size(), -1);
-    for (size_t iPath = 0; iPath < runHandle->triggerPathInfos.size(); ++iPath) {
-        const std::string& pathName = runHandle->triggerPathInfos[iPath].name_;
-        ///std::cout << "[Check iPath " << iPath << "] " << pathName << std::endl;
-
-        boost::smatch matched_substrings;
-        if (boost::regex_match(pathName, matched_substrings, globalCache->hltVersionPattern_) && matched_substrings.size() > 1) {
-            // need matched_substrings[1] because matched_substrings[0] is always the entire string
-            runCache->triggerPathsUnversionedNames_[iPath] = matched_substrings[1];
-            ///std::cout << " -> unversioned name: " << matched_substrings[1] << std::endl;
-        }
-
-        for (size_t iRequestedPath = 0; iRequestedPath < globalCache->hltPaths_.size(); ++iRequestedPath) {
-            ///std::cout << "[Check iRequestedPath " << iRequestedPath << "] " << globalCache->hltPaths_[iRequestedPath] << std::endl;
-            if (runCache->triggerPathsUnversionedNames_[iPath] == globalCache->hltPaths_[iRequestedPath]) {
-                std::cout << " -> matched! " << iPath << " = " << iRequestedPath << std::endl;
-                runCache->triggerPathsIndicesInConfig_[iPath] = iRequestedPath;
-                break;
-            }
-        }
+    // (memoized per trigger menu and shared between modules)
+    std::vector<std::string> pathNames;
+    pathNames.reserve(runHandle->triggerPathInfos.size());
+    for (const auto& pathInfo : runHandle->triggerPathInfos) {
+        pathNames.push_back(pathInfo.name_);
     }
+    const auto resolvedPaths = karma::TriggerMenuRegistry::instance().resolvePaths(
+        runHandle->triggerMenuName, pathNames, globalCache->hltPaths_);
+
+    runCache->triggerPathsUnversionedNames_ = resolvedPaths->unversionedNames;
+    runCache->triggerPathsIndicesInConfig_ = resolvedPaths->indicesInConfig;
 
     return runCache;
 }